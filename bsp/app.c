@@ -45,22 +45,22 @@ static void task1_thread_entry(void *param)
 int task2_togo;
 static void task2_thread_entry(void *param)
 {
+	smc_uint32_t last_wake = smc_tick_get();
+
 	while (1) {
-		task2_togo = 0;
-		smc_thread_delay(4);
-		task2_togo = 1;
-		smc_thread_delay(4);
+		task2_togo = !task2_togo;
+		smc_thread_delay_until(&last_wake, 4);
 	}
 }
 
 int task3_togo;
 static void task3_thread_entry(void *param)
 {
+	smc_uint32_t last_wake = smc_tick_get();
+
 	while (1) {
-		task3_togo = 0;
-		smc_thread_delay(8);
-		task3_togo = 1;
-		smc_thread_delay(8);
+		task3_togo = !task3_togo;
+		smc_thread_delay_until(&last_wake, 8);
 	}
 }
 
@@ -0,0 +1,45 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-21
+ * Describe: The init functions of the benchmark samples, invoke one of them
+ *           in smc_app_init() instead of the application threads.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "smc_rtos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_RWLOCK
+/**
+ * eight readers and one writer share a reader-writer lock
+ */
+void smc_rwlock_bench_init(void);
+#endif
+
+#if defined(SMC_USING_SST) && defined(SMC_USING_SEMAPHORE)
+/**
+ * a run-to-completion task against a thread waked by semaphore
+ */
+void smc_sst_bench_init(void);
+#endif
+
+#ifdef SMC_USING_WAKEUP_LATENCY
+/**
+ * periodic threads measure the wakeup-to-run latency
+ */
+void smc_cyclictest_init(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_H
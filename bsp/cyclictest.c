@@ -0,0 +1,88 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-09
+ * Describe: The cyclictest of SMC-RTOS, some periodic threads measure the
+ *           cycles from the tick interrupt releasing them to running, and
+ *           the kernel records the wakeup-to-run latency per priority.
+ *           Invoke smc_cyclictest_init() in smc_app_init() instead of the
+ *           application threads, and read the results by debugger. On QEMU
+ *           virt, "make run-cyclictest" in bsp/qemu-virt builds and runs it.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_rtos.h"
+#include "bench.h"
+
+#ifdef SMC_USING_WAKEUP_LATENCY
+
+#define CYCLIC_THREADS      4
+#define CYCLIC_PRIORITY     1       /* priority of the first thread */
+#define CYCLIC_PERIOD       1       /* period of the first thread in ticks */
+#define CYCLIC_STACK_SIZE   512
+
+struct cyclic_result {
+	smc_uint32_t loops;
+	smc_uint32_t overruns;          /* the release is missed */
+	smc_uint32_t min;               /* tick interrupt to running, cpu cycles */
+	smc_uint32_t max;
+	smc_uint64_t sum;
+};
+
+static smc_uint8_t cyclic_stack[CYCLIC_THREADS][CYCLIC_STACK_SIZE];
+static smc_thread_t cyclic_thread[CYCLIC_THREADS];
+
+struct cyclic_result cyclic_result[CYCLIC_THREADS];
+smc_latency_t cyclic_latency[CYCLIC_THREADS];   /* kernel histograms of the threads */
+
+static void cyclic_thread_entry(void *param)
+{
+	struct cyclic_result *result = (struct cyclic_result *)param;
+	smc_uint32_t index  = result - cyclic_result;
+	smc_uint32_t period = CYCLIC_PERIOD << index;
+	smc_uint32_t last_wake;
+	smc_uint32_t cycle;
+	smc_uint32_t latency;
+
+	result->min = 0xFFFFFFFFU;
+	last_wake   = smc_tick_get();
+
+	while (1) {
+		if (smc_thread_delay_until(&last_wake, period) != SMC_OK) {
+			result->overruns++;
+			continue;
+		}
+
+		/* the tick releasing this thread is the latest one */
+		if (smc_tick_get_stamp(&cycle) != last_wake)
+			continue;
+		latency = smc_cpu_cycle_get() - cycle;
+
+		if (latency < result->min)
+			result->min = latency;
+		if (latency > result->max)
+			result->max = latency;
+		result->sum += latency;
+		result->loops++;
+
+		smc_latency_get(CYCLIC_PRIORITY + index, &cyclic_latency[index]);
+	}
+}
+
+void smc_cyclictest_init(void)
+{
+	smc_uint32_t i;
+
+	/* the shortest period has the highest priority */
+	for (i = 0; i < CYCLIC_THREADS; i++)
+		smc_thread_init(&cyclic_thread[i],
+		                cyclic_thread_entry,
+		                &cyclic_result[i],
+		                CYCLIC_PRIORITY + i,
+		                cyclic_stack[i],
+		                CYCLIC_STACK_SIZE,
+		                20);
+}
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-03
+ * Describe: Init hardware for QEMU virt (RV32IMAC, machine mode). The tick
+ *           is made by the CLINT in libcpu/riscv32.c, the board only routes
+ *           the PLIC to hart 0.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_rtos.h"
+
+#define PLIC_BASE            0x0C000000
+#define PLIC_PRIORITY(irq)   (PLIC_BASE + ((irq) << 2))
+#define PLIC_THRESHOLD       (PLIC_BASE + 0x200000)    /* hart 0 machine mode */
+#define PLIC_CLAIM           (PLIC_BASE + 0x200004)
+#define PLIC_SOURCES         53                        /* the fewest of QEMU versions */
+
+#define MIE_MEIE             0x00000800
+#define CAUSE_M_EXTERNAL     11
+
+void smc_cpu_irq_handler(smc_uint32_t cause);
+
+/**
+ * This function will be invoked by the port for the local interrupts except
+ * the software and timer interrupt, the external interrupt is claimed from
+ * PLIC and completed after the handler.
+ *
+ * @param cause [the interrupt cause without interrupt bit]
+ */
+void smc_cpu_irq_handler(smc_uint32_t cause)
+{
+	smc_uint32_t irq;
+
+	if (cause != CAUSE_M_EXTERNAL)
+		return;
+
+	irq = smc_mem_read_32(PLIC_CLAIM);
+	if (irq == 0U)
+		return;
+
+	/* enter interrupt */
+	smc_enter_interrupt();
+
+#ifdef SMC_USING_THREADED_IRQ
+	smc_irq_dispatch(irq);
+#endif
+
+	/* exit interrupt */
+	smc_exit_interrupt();
+
+	smc_mem_write_32(PLIC_CLAIM, irq);
+}
+
+/**
+ * This function will init hardware for the special board, every source has
+ * the same PLIC priority and is gated by smc_cpu_irq_unmask() only.
+ */
+void smc_hw_board_init(void)
+{
+	smc_uint32_t irq;
+
+	for (irq = 1; irq < PLIC_SOURCES; irq++)
+		smc_mem_write_32(PLIC_PRIORITY(irq), 1);
+	smc_mem_write_32(PLIC_THRESHOLD, 0);
+
+	__asm__ volatile ("csrs mie, %0" : : "r"(MIE_MEIE));
+}
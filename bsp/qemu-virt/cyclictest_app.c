@@ -0,0 +1,17 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-09
+ * Describe: The application of the cyclictest image, it runs the threads
+ *           of bsp/cyclictest.c only.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_rtos.h"
+#include "bench.h"
+
+void smc_app_init(void)
+{
+	smc_cyclictest_init();
+}
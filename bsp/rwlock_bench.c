@@ -0,0 +1,123 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-21
+ * Describe: The benchmark of reader-writer lock, eight readers of different
+ *           priorities and one low priority writer share a table. It
+ *           measures the lock waiting time in cpu cycles and counts how
+ *           often the writer inherits a reader priority. Invoke
+ *           smc_rwlock_bench_init() in smc_app_init(), and read the results
+ *           by debugger.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_rtos.h"
+#include "bench.h"
+
+#ifdef SMC_USING_RWLOCK
+
+#define RW_READERS          8
+#define RW_READER_PRIORITY  2       /* priority of the first reader */
+#define RW_WRITER_PRIORITY  (RW_READER_PRIORITY + RW_READERS)
+#define RW_STACK_SIZE       512
+#define RW_TABLE_SIZE       16
+
+static smc_uint8_t reader_stack[RW_READERS][RW_STACK_SIZE];
+static smc_thread_t reader_thread[RW_READERS];
+static smc_uint8_t writer_stack[RW_STACK_SIZE];
+static smc_thread_t writer_thread;
+
+static smc_rwlock_t rw_lock;
+static volatile smc_uint32_t rw_table[RW_TABLE_SIZE];
+
+smc_uint32_t rw_reads;
+smc_uint32_t rw_writes;
+smc_uint32_t rw_torn;               /* the table is changed while reading */
+smc_uint32_t rw_boosts;             /* the writer inherits a reader priority */
+smc_uint32_t rw_read_wait_max;      /* read lock waiting, cpu cycles */
+smc_uint64_t rw_read_wait_sum;
+smc_uint32_t rw_write_wait_max;     /* write lock waiting, cpu cycles */
+smc_uint64_t rw_write_wait_sum;
+
+static void rw_record(smc_uint32_t stamp, smc_uint32_t *max, smc_uint64_t *sum)
+{
+	smc_uint32_t cycles = smc_cpu_cycle_get() - stamp;
+
+	if (cycles > *max)
+		*max = cycles;
+	*sum += cycles;
+}
+
+static void reader_thread_entry(void *param)
+{
+	smc_uint32_t stamp;
+	smc_uint32_t i;
+
+	while (1) {
+		stamp = smc_cpu_cycle_get();
+		smc_rwlock_read_lock(&rw_lock, SMC_RWLOCK_WAIT_FOREVER);
+		rw_record(stamp, &rw_read_wait_max, &rw_read_wait_sum);
+
+		for (i = 1; i < RW_TABLE_SIZE; i++) {
+			if (rw_table[i] != rw_table[0]) {
+				rw_torn++;
+				break;
+			}
+		}
+		rw_reads++;
+
+		smc_rwlock_unlock(&rw_lock);
+		smc_thread_delay(1);
+	}
+}
+
+static void writer_thread_entry(void *param)
+{
+	smc_uint32_t stamp;
+	smc_uint32_t i;
+
+	while (1) {
+		stamp = smc_cpu_cycle_get();
+		smc_rwlock_write_lock(&rw_lock, SMC_RWLOCK_WAIT_FOREVER);
+		rw_record(stamp, &rw_write_wait_max, &rw_write_wait_sum);
+
+		/* the readers waked meanwhile are blocked by the writer */
+		for (i = 0; i < RW_TABLE_SIZE; i++)
+			rw_table[i] = rw_writes + 1;
+		rw_writes++;
+
+		if (smc_thread_current->priority != smc_thread_current->init_priority)
+			rw_boosts++;
+
+		smc_rwlock_unlock(&rw_lock);
+		smc_thread_delay(1);
+	}
+}
+
+void smc_rwlock_bench_init(void)
+{
+	smc_uint32_t i;
+
+	smc_rwlock_init(&rw_lock);
+
+	for (i = 0; i < RW_READERS; i++)
+		smc_thread_init(&reader_thread[i],
+		                reader_thread_entry,
+		                NULL,
+		                RW_READER_PRIORITY + i,
+		                reader_stack[i],
+		                RW_STACK_SIZE,
+		                20);
+
+	/* the writer has the lowest priority, so it's preempted holding the lock */
+	smc_thread_init(&writer_thread,
+	                writer_thread_entry,
+	                NULL,
+	                RW_WRITER_PRIORITY,
+	                writer_stack,
+	                RW_STACK_SIZE,
+	                20);
+}
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-29
+ * Describe: The benchmark of run-to-completion task against thread, it
+ *           measures the dispatch latency in cpu cycles and the RAM used.
+ *           The task handler runs on the interrupt stack shared by all the
+ *           tasks and interrupts, so its frames are not in sst_ram_bytes.
+ *           That stack must be sized for the deepest nesting of interrupts
+ *           and tasks once, but each thread needs a private stack.
+ *           Invoke smc_sst_bench_init() in smc_app_init(), and read the
+ *           results by debugger.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_rtos.h"
+#include "bench.h"
+
+#if defined(SMC_USING_SST) && defined(SMC_USING_SEMAPHORE)
+
+#define BENCH_LOOPS     1000
+
+static smc_uint8_t bench_stack[512];
+static smc_thread_t bench_thread;
+
+static smc_uint8_t waiter_stack[512];
+static smc_thread_t waiter_thread;
+static smc_sem_t waiter_sem;
+
+static void *sst_queue[4];
+static smc_sst_task_t sst_task;
+
+static volatile smc_uint32_t post_cycle;
+
+smc_uint32_t sst_latency_max;       /* post to handler, cpu cycles */
+smc_uint32_t sst_latency_sum;
+smc_uint32_t thread_latency_max;    /* release to waked thread, cpu cycles */
+smc_uint32_t thread_latency_sum;
+smc_uint32_t sst_ram_bytes;         /* task object and event queue */
+smc_uint32_t thread_ram_bytes;      /* thread object and stack */
+
+static void bench_record(smc_uint32_t *max, smc_uint32_t *sum)
+{
+	smc_uint32_t cycles = smc_cpu_cycle_get() - post_cycle;
+
+	if (cycles > *max)
+		*max = cycles;
+	*sum += cycles;
+}
+
+static void sst_handler(smc_sst_task_t *task, void *event)
+{
+	bench_record(&sst_latency_max, &sst_latency_sum);
+}
+
+static void waiter_thread_entry(void *param)
+{
+	while (1) {
+		smc_sem_pend(&waiter_sem, SMC_SEM_WAIT_FOREVER);
+		bench_record(&thread_latency_max, &thread_latency_sum);
+	}
+}
+
+static void bench_thread_entry(void *param)
+{
+	smc_uint32_t i;
+
+	for (i = 0; i < BENCH_LOOPS; i++) {
+		post_cycle = smc_cpu_cycle_get();
+		smc_sst_post(&sst_task, NULL);
+		smc_thread_delay(1);
+
+		post_cycle = smc_cpu_cycle_get();
+		smc_sem_release(&waiter_sem);
+		smc_thread_delay(1);
+	}
+
+	sst_ram_bytes    = sizeof(sst_task) + sizeof(sst_queue);
+	thread_ram_bytes = sizeof(waiter_thread) + sizeof(waiter_stack);
+
+	while (1)
+		smc_thread_delay(SMC_TICKS_PER_SECOND);
+}
+
+void smc_sst_bench_init(void)
+{
+	smc_sst_task_init(&sst_task, sst_handler, 0, sst_queue, 4);
+	smc_sem_init(&waiter_sem, 0);
+
+	/* the waked thread has higher priority than the benchmark thread */
+	smc_thread_init(&waiter_thread,
+	                waiter_thread_entry,
+	                NULL,
+	                2,
+	                waiter_stack,
+	                sizeof(waiter_stack),
+	                20);
+	smc_thread_init(&bench_thread,
+	                bench_thread_entry,
+	                NULL,
+	                3,
+	                bench_stack,
+	                sizeof(bench_stack),
+	                20);
+}
+
+#endif
@@ -19,5 +19,79 @@
  */
 #define SMC_USING_SEMAPHORE			/* using semaphore for SMC-RTOS */
 #define SMC_USING_CPU_USAGE			/* using cpu usage for SMC-RTOS */
+/* #define SMC_USING_BITBAND */		/* using bit-band for bit map on Cortex-M3/M4, kernel data must be in SRAM */
+/* #define SMC_USING_HRTIMER */			/* using high-resolution timer, BSP provides counter and compare */
+/* #define SMC_USING_RWLOCK */			/* using reader-writer lock for SMC-RTOS */
+/* #define SMC_USING_COND */			/* using condition variable, it needs semaphore as mutex */
+/* #define SMC_USING_WAITSET */			/* using wait set to wait for several objects at once */
+/* #define SMC_USING_WORKQUEUE */		/* using work queue served by worker threads, it needs semaphore */
+/* #define SMC_USING_TIMER_SLACK */		/* using timer slack to coalesce expiry, and deferrable timer with PM */
+/* #define SMC_USING_SST */			/* using run-to-completion tasks, BSP provides a spare interrupt per task priority */
+/* #define SMC_USING_THREAD_STATS */		/* using jitter and deadline statistics for periodic thread */
+/* #define SMC_USING_PM */			/* using idle power governor, it conflicts with cpu usage */
+/* #define SMC_USING_THREADED_IRQ */		/* using threaded interrupt handler */
+/* #define SMC_USING_IRQOFF_PROFILE */		/* using interrupt disabled time profiler, only for debug */
+/* #define SMC_USING_LOCK_STATS */		/* using contention statistics of semaphore and reader-writer lock */
+/* #define SMC_USING_WAKEUP_LATENCY */		/* using wakeup-to-run latency histogram per priority */
+/* #define SMC_USING_STREAM */			/* using byte stream with trigger level for one writer and one reader */
+/* #define SMC_USING_PBUF */			/* using reference counted packet buffer pool, it needs semaphore */
+/* #define SMC_USING_TOPIC */			/* using publish/subscribe topic with lock-free latest value read */
+
+/**
+ * high-resolution timer configration
+ */
+#define SMC_HRTIMER_COUNTER_HZ		1000000	/* frequency of the high-resolution counter, multiple of 1MHz */
+
+/**
+ * wait set configration
+ */
+#define SMC_WAITSET_MAX			4	/* how many objects can be waited at once */
+
+/**
+ * work queue configration
+ */
+#define SMC_WORKQUEUE_SLICE_TICK	10	/* the time slice of worker threads */
+
+/**
+ * periodic thread statistics configration
+ */
+#define SMC_THREAD_JITTER_BUCKETS	12	/* how many log2 buckets of release jitter histogram */
+
+/**
+ * idle power governor configration
+ */
+#define SMC_PM_STATE_MAX		4	/* how many idle states, including spin and WFI */
+#define SMC_PM_WFI_LATENCY_US		2	/* exit latency of WFI state */
+
+/**
+ * threaded interrupt configration
+ */
+#define SMC_IRQ_MAX			64	/* how many external interrupts can be threaded */
+#define SMC_IRQ_SLICE_TICK		10	/* the time slice of interrupt handler threads */
+
+/**
+ * interrupt disabled time profiler configration
+ */
+#define SMC_IRQOFF_SITE_MAX		64	/* how many critical section call sites can be recorded */
+#define SMC_IRQOFF_HIST_BUCKETS		16	/* how many log2 buckets of interrupt disabled cycles histogram */
+
+/**
+ * wakeup latency configration
+ */
+#define SMC_LATENCY_BUCKETS		16	/* how many log2 buckets of wakeup-to-run cycles histogram */
+
+/**
+ * run-to-completion task configration, each task priority takes a spare
+ * interrupt and an interrupt priority level on Cortex-M
+ */
+#define SMC_SST_PRIORITY_MAX		4	/* SMC-RTOS support 4 run-to-completion task priority for max */
+#define SMC_SST_IRQ_BASE		32	/* the interrupt of task priority n is SMC_SST_IRQ_BASE + n */
+#define SMC_SST_NVIC_PRIO_BITS		4	/* the implemented interrupt priority bits of the device */
+
+/**
+ * C++ coroutine configration
+ */
+#define SMC_CORO_FRAME_SIZE		128	/* how many bytes for a coroutine frame */
+#define SMC_CORO_FRAME_MAX		16	/* how many coroutine frames in pool */
 
 #endif // SMC_CONFIG_H
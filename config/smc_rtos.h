@@ -17,11 +17,27 @@ extern "C" {
 
 #include "smc_def.h"
 #include "smc_list.h"
+#include "smc_atomic.h"
 #include "smc_thread.h"
 #include "smc_core.h"
 #include "smc_cpu.h"
 #include "smc_timer.h"
+#include "smc_waitq.h"
 #include "smc_sem.h"
+#include "smc_hrtimer.h"
+#include "smc_rwlock.h"
+#include "smc_cond.h"
+#include "smc_waitset.h"
+#include "smc_workqueue.h"
+#include "smc_sst.h"
+#include "smc_pm.h"
+#include "smc_irq.h"
+#include "smc_irqoff.h"
+#include "smc_lockstat.h"
+#include "smc_latency.h"
+#include "smc_stream.h"
+#include "smc_pbuf.h"
+#include "smc_topic.h"
 
 #ifdef __cplusplus
 }
@@ -7,6 +7,8 @@
  * it under the terms of the GNU General Public License version 2 as
  * published by the Free Software Foundation.
  */
+#define SMC_CPU_PORT
+
 #include "smc_rtos.h"
 
 #define NVIC_INT_CTRL        0xE000ED04
@@ -14,6 +16,42 @@
 #define NVIC_SYSPRI4         0xE000ED22
 #define NVIC_PENDSV_PRI      0xFFFF
 
+#define NVIC_ISER            0xE000E100
+#define NVIC_ICER            0xE000E180
+
+#ifdef SMC_USING_SST
+#define NVIC_ISPR            0xE000E200
+#define NVIC_IPR             0xE000E400
+#define NVIC_SYSTICK_PRI     0xE000ED23
+#define NVIC_VECTACTIVE      0x000001FF
+
+#if SMC_SST_PRIORITY_MAX > (1 << SMC_SST_NVIC_PRIO_BITS) - 2
+#error each task priority needs an interrupt level between SysTick and PendSV
+#endif
+
+/* task priority n, the lowest task is just above PendSV and -1 is SysTick */
+#define NVIC_SST_PRI(n)      ((((1 << SMC_SST_NVIC_PRIO_BITS) - 1 - SMC_SST_PRIORITY_MAX + (n)) \
+                               << (8 - SMC_SST_NVIC_PRIO_BITS)) & 0xFF)
+#endif
+
+#define DEMCR                0xE000EDFC
+#define DEMCR_TRCENA         0x01000000
+#define DWT_CTRL             0xE0001000
+#define DWT_CTRL_CYCCNTENA   0x00000001
+#define DWT_CYCCNT           0xE0001004
+
+/**
+ * This function will enable the DWT cycle counter
+ */
+static void smc_cpu_cycle_enable(void)
+{
+	if (!(smc_mem_read_32(DWT_CTRL) & DWT_CTRL_CYCCNTENA)) {
+		smc_mem_write_32(DEMCR, smc_mem_read_32(DEMCR) | DEMCR_TRCENA);
+		smc_mem_write_32(DWT_CYCCNT, 0);
+		smc_mem_write_32(DWT_CTRL, smc_mem_read_32(DWT_CTRL) | DWT_CTRL_CYCCNTENA);
+	}
+}
+
 /**
  * This function will make contex switch
  */
@@ -21,6 +59,9 @@ __asm void PendSV_Handler(void)
 {
 	IMPORT smc_thread_current
 	IMPORT smc_thread_ready
+#ifdef SMC_USING_WAKEUP_LATENCY
+	IMPORT smc_latency_switch_in
+#endif
 
 	CPSID   I                        /* Prevent interruption during context switch */
 	LDR R1, =smc_thread_current
@@ -42,6 +83,13 @@ PendSV_Handler_Nosave
 	LDR R2, [R1]
 	STR R2, [R0]
 
+#ifdef SMC_USING_WAKEUP_LATENCY
+	PUSH {R2, LR}                    /* smc_latency_switch_in(smc_thread_current) */
+	MOV R0, R2
+	BL smc_latency_switch_in
+	POP {R2, LR}
+#endif
+
 	LDR R3, [R2]
 	LDMFD R3!, {R4-R11}
 
@@ -165,8 +213,15 @@ void smc_thread_intrrupt_switch(void)
 void smc_thread_switch_to(void)
 {
 	smc_mem_write_32(NVIC_SYSPRI4, NVIC_PENDSV_PRI);
+#ifdef SMC_USING_SST
+	/* the tick isn't delayed by the tasks */
+	smc_mem_write_8(NVIC_SYSTICK_PRI, NVIC_SST_PRI(-1));
+#endif
 	smc_mem_write_32(NVIC_INT_CTRL, NVIC_PENDSVSET);
 
+	/* the cycle counter is used by kernel delay and profiling */
+	smc_cpu_cycle_enable();
+
 	/*
 	 * enable interrupt because the interrupt has been diasble
 	 * before the system starts.
@@ -200,6 +255,107 @@ __asm void smc_cpu_enable_interrupt(smc_uint32_t status)
 	BX      LR
 }
 
+/**
+ * This function will disable an external interrupt in NVIC, it takes effect
+ * before return.
+ *
+ * @param irq [the interrupt number]
+ */
+void smc_cpu_irq_mask(smc_uint32_t irq)
+{
+	smc_mem_write_32(NVIC_ICER + ((irq >> 5) << 2), 1U << (irq & 0x1F));
+	__dsb(0xF);
+	__isb(0xF);
+}
+
+/**
+ * This function will enable an external interrupt in NVIC
+ *
+ * @param irq [the interrupt number]
+ */
+void smc_cpu_irq_unmask(smc_uint32_t irq)
+{
+	smc_mem_write_32(NVIC_ISER + ((irq >> 5) << 2), 1U << (irq & 0x1F));
+}
+
+#ifdef SMC_USING_SST
+/**
+ * This function will set up the interrupt of a run-to-completion task
+ * priority, its interrupt priority is between SysTick and PendSV.
+ *
+ * @param priority [the task priority]
+ */
+void smc_hw_sst_enable(smc_uint8_t priority)
+{
+	smc_uint32_t irq = SMC_SST_IRQ_BASE + priority;
+
+	smc_mem_write_8(NVIC_IPR + irq, NVIC_SST_PRI(priority));
+	smc_cpu_irq_unmask(irq);
+}
+
+/**
+ * This function will pend the interrupt of a task priority, a higher task
+ * preempts the caller as soon as the interrupt is enabled.
+ *
+ * @param priority [the task priority]
+ */
+void smc_hw_sst_trigger(smc_uint8_t priority)
+{
+	smc_uint32_t irq = SMC_SST_IRQ_BASE + priority;
+
+	smc_mem_write_32(NVIC_ISPR + ((irq >> 5) << 2), 1U << (irq & 0x1F));
+	__dsb(0xF);
+	__isb(0xF);
+}
+
+/**
+ * The interrupt handler of all the task priorities, the task priority is
+ * found by the active exception number.
+ */
+void smc_sst_irq_handler(void)
+{
+	/* the exception number of interrupt n is n + 16 */
+	smc_uint32_t irq = (smc_mem_read_32(NVIC_INT_CTRL) & NVIC_VECTACTIVE) - 16;
+
+	/* enter interrupt */
+	smc_enter_interrupt();
+
+	smc_sst_isr(irq - SMC_SST_IRQ_BASE);
+
+	/* exit interrupt */
+	smc_exit_interrupt();
+}
+#endif
+
+/**
+ * This function will make cpu sleep until an interrupt is pending, it can
+ * be waked even if interrupt is disabled by PRIMASK.
+ */
+void smc_cpu_wait_for_interrupt(void)
+{
+	__wfi();
+}
+
+/**
+ * This function will return the free-running cpu cycle counter.
+ *
+ * @return [the DWT cycle counter]
+ */
+smc_uint32_t smc_cpu_cycle_get(void)
+{
+	return smc_mem_read_32(DWT_CYCCNT);
+}
+
+/**
+ * This function will return how many cpu cycles are there in a microsecond.
+ *
+ * @return [the cycles of a microsecond]
+ */
+smc_uint32_t smc_cpu_cycles_per_us(void)
+{
+	return SystemCoreClock / 1000000;
+}
+
 /**
  * This function will delay some microseconds(us).
  *
@@ -207,13 +363,19 @@ __asm void smc_cpu_enable_interrupt(smc_uint32_t status)
  */
 void smc_cpu_us_delay(smc_uint32_t us)
 {
-	smc_uint32_t delta;
+	smc_uint32_t start;
+	smc_uint32_t cycles_per_us = smc_cpu_cycles_per_us();
 
-	/* Get delay timer count */
-	us = us * (SysTick->LOAD / (1000000 / SMC_TIMER_PERIODIC));
+	smc_cpu_cycle_enable();
+	start = smc_cpu_cycle_get();
 
-	/* Get current timer count */
-	delta = SysTick->VAL;
+	/* delay one second at most each time, the cycles never overflow */
+	while (us > 0U) {
+		smc_uint32_t n      = us > 1000000U ? 1000000U : us;
+		smc_uint32_t cycles = n * cycles_per_us;
 
-	while (delta - SysTick->VAL < us);
+		while (smc_cpu_cycle_get() - start < cycles);
+		start += cycles;
+		us    -= n;
+	}
 }
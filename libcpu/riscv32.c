@@ -0,0 +1,562 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-03
+ * Describe: SMC-RTOS for RISC-V (RV32IMAC, machine mode, CLINT timer)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#define SMC_CPU_PORT
+
+#include "smc_rtos.h"
+
+/**
+ * The CLINT layout is the same on QEMU virt and sifive_e, only the mtime
+ * frequency is different (virt: 10MHz, sifive_e: 32768Hz). The board can
+ * override them before compile.
+ */
+#ifndef SMC_CPU_CLINT_BASE
+#define SMC_CPU_CLINT_BASE   0x02000000
+#endif
+
+#ifndef SMC_CPU_MTIME_HZ
+#define SMC_CPU_MTIME_HZ     10000000
+#endif
+
+/**
+ * The PLIC of QEMU virt and sifive_e, the enable bits of hart 0 machine mode
+ * context are used.
+ */
+#ifndef SMC_CPU_PLIC_BASE
+#define SMC_CPU_PLIC_BASE    0x0C000000
+#endif
+
+#define PLIC_ENABLE(irq)     (SMC_CPU_PLIC_BASE + 0x2000 + (((irq) >> 5) << 2))
+
+#define CLINT_MSIP           (SMC_CPU_CLINT_BASE + 0x0000)
+#define CLINT_MTIMECMP_LO    (SMC_CPU_CLINT_BASE + 0x4000)
+#define CLINT_MTIMECMP_HI    (SMC_CPU_CLINT_BASE + 0x4004)
+#define CLINT_MTIME_LO       (SMC_CPU_CLINT_BASE + 0xBFF8)
+#define CLINT_MTIME_HI       (SMC_CPU_CLINT_BASE + 0xBFFC)
+
+#define MSTATUS_MIE          0x00000008
+#define MSTATUS_MPIE         0x00000080
+#define MSTATUS_MPP_M        0x00001800
+#define MIE_MSIE             0x00000008
+#define MIE_MTIE             0x00000080
+#define MCAUSE_INT           0x80000000
+#define MCAUSE_M_SOFT        (MCAUSE_INT | 3)
+#define MCAUSE_M_TIMER       (MCAUSE_INT | 7)
+
+#define TICK_INTERVAL        (SMC_CPU_MTIME_HZ / SMC_TICKS_PER_SECOND)
+
+/**
+ * Context frame saved on thread stack, slot n holds register xn. The slot of
+ * sp(x2) keeps mstatus, slot of x0 keeps mepc, gp(x3) and tp(x4) are not saved.
+ */
+#define FRAME_WORDS          32
+#define FRAME_MEPC           0
+#define FRAME_MSTATUS        2
+#define FRAME_A0             10
+
+static smc_uint64_t smc_cpu_mtimecmp;         /* next tick compare value */
+
+#ifdef SMC_USING_SST
+/**
+ * The software interrupt is shared by the thread switch and all the task
+ * priorities, the task levels are kept by software.
+ */
+static volatile smc_uint8_t smc_cpu_switch_pending;                    /* thread switch is requested */
+static volatile smc_uint32_t smc_cpu_sst_pending;                      /* pended task priority bit map */
+static smc_uint8_t smc_cpu_sst_current = SMC_SST_PRIORITY_MAX;         /* the running task priority */
+#endif
+
+void smc_cpu_trap_handler(smc_uint32_t mcause);
+
+/**
+ * Trap entry, save the context to current thread stack, dispatch the trap and
+ * restore the context of smc_thread_current, which may be changed by the
+ * machine software interrupt. The outermost trap dispatches on the interrupt
+ * stack kept in mscratch, which is the main stack as MSP of Cortex-M, so the
+ * thread stacks only hold a context frame for interrupts. mscratch is zero
+ * while a trap is being dispatched, the nested trap stays on that stack.
+ */
+__asm__(
+	"	.pushsection .text.smc_trap_entry, \"ax\"\n"
+	"	.balign 4\n"
+	"	.global smc_trap_entry\n"
+	"smc_trap_entry:\n"
+	"	addi sp, sp, -128\n"
+	"	sw   x1,   1 * 4(sp)\n"
+	"	sw   x5,   5 * 4(sp)\n"
+	"	sw   x6,   6 * 4(sp)\n"
+	"	sw   x7,   7 * 4(sp)\n"
+	"	sw   x8,   8 * 4(sp)\n"
+	"	sw   x9,   9 * 4(sp)\n"
+	"	sw   x10, 10 * 4(sp)\n"
+	"	sw   x11, 11 * 4(sp)\n"
+	"	sw   x12, 12 * 4(sp)\n"
+	"	sw   x13, 13 * 4(sp)\n"
+	"	sw   x14, 14 * 4(sp)\n"
+	"	sw   x15, 15 * 4(sp)\n"
+	"	sw   x16, 16 * 4(sp)\n"
+	"	sw   x17, 17 * 4(sp)\n"
+	"	sw   x18, 18 * 4(sp)\n"
+	"	sw   x19, 19 * 4(sp)\n"
+	"	sw   x20, 20 * 4(sp)\n"
+	"	sw   x21, 21 * 4(sp)\n"
+	"	sw   x22, 22 * 4(sp)\n"
+	"	sw   x23, 23 * 4(sp)\n"
+	"	sw   x24, 24 * 4(sp)\n"
+	"	sw   x25, 25 * 4(sp)\n"
+	"	sw   x26, 26 * 4(sp)\n"
+	"	sw   x27, 27 * 4(sp)\n"
+	"	sw   x28, 28 * 4(sp)\n"
+	"	sw   x29, 29 * 4(sp)\n"
+	"	sw   x30, 30 * 4(sp)\n"
+	"	sw   x31, 31 * 4(sp)\n"
+	"	csrr t0, mepc\n"
+	"	sw   t0,   0 * 4(sp)\n"
+	"	csrr t0, mstatus\n"
+	"	sw   t0,   2 * 4(sp)\n"
+
+	/* skip save sp for the first switch, smc_thread_current->sp = sp */
+	"	la   t0, smc_thread_current\n"
+	"	lw   t0, 0(t0)\n"
+	"	beqz t0, 1f\n"
+	"	sw   sp, 0(t0)\n"
+	"1:\n"
+
+	/* switch to the interrupt stack, s1 keeps it for the outermost trap */
+	"	csrrw s1, mscratch, zero\n"
+	"	beqz s1, 2f\n"
+	"	mv   sp, s1\n"
+	"2:\n"
+	"	csrr a0, mcause\n"
+	"	call smc_cpu_trap_handler\n"
+	"	beqz s1, 3f\n"
+	"	csrw mscratch, s1\n"
+	"3:\n"
+
+	/* sp = smc_thread_current->sp */
+	"	la   t0, smc_thread_current\n"
+	"	lw   t0, 0(t0)\n"
+	"	lw   sp, 0(t0)\n"
+	"	lw   t0,   0 * 4(sp)\n"
+	"	csrw mepc, t0\n"
+	"	lw   t0,   2 * 4(sp)\n"
+	"	csrw mstatus, t0\n"
+	"	lw   x1,   1 * 4(sp)\n"
+	"	lw   x6,   6 * 4(sp)\n"
+	"	lw   x7,   7 * 4(sp)\n"
+	"	lw   x8,   8 * 4(sp)\n"
+	"	lw   x9,   9 * 4(sp)\n"
+	"	lw   x10, 10 * 4(sp)\n"
+	"	lw   x11, 11 * 4(sp)\n"
+	"	lw   x12, 12 * 4(sp)\n"
+	"	lw   x13, 13 * 4(sp)\n"
+	"	lw   x14, 14 * 4(sp)\n"
+	"	lw   x15, 15 * 4(sp)\n"
+	"	lw   x16, 16 * 4(sp)\n"
+	"	lw   x17, 17 * 4(sp)\n"
+	"	lw   x18, 18 * 4(sp)\n"
+	"	lw   x19, 19 * 4(sp)\n"
+	"	lw   x20, 20 * 4(sp)\n"
+	"	lw   x21, 21 * 4(sp)\n"
+	"	lw   x22, 22 * 4(sp)\n"
+	"	lw   x23, 23 * 4(sp)\n"
+	"	lw   x24, 24 * 4(sp)\n"
+	"	lw   x25, 25 * 4(sp)\n"
+	"	lw   x26, 26 * 4(sp)\n"
+	"	lw   x27, 27 * 4(sp)\n"
+	"	lw   x28, 28 * 4(sp)\n"
+	"	lw   x29, 29 * 4(sp)\n"
+	"	lw   x30, 30 * 4(sp)\n"
+	"	lw   x31, 31 * 4(sp)\n"
+	"	lw   x5,   5 * 4(sp)\n"
+
+	/* invalidate the reservation of the interrupted LR/SC sequence */
+	"	sc.w zero, zero, (sp)\n"
+	"	addi sp, sp, 128\n"
+	"	mret\n"
+	"	.popsection\n"
+);
+
+void smc_trap_entry(void);
+
+/**
+ * This function will read the 64bit mtime counter
+ *
+ * @return [the mtime counter]
+ */
+static smc_uint64_t smc_cpu_mtime_read(void)
+{
+	smc_uint32_t hi, lo;
+
+	/* read again if the low word overflow between two read */
+	do {
+		hi = smc_mem_read_32(CLINT_MTIME_HI);
+		lo = smc_mem_read_32(CLINT_MTIME_LO);
+	} while (hi != smc_mem_read_32(CLINT_MTIME_HI));
+
+	return ((smc_uint64_t)hi << 32) | lo;
+}
+
+/**
+ * This function will set the 64bit mtimecmp without a spurious timer
+ * interrupt in the middle of writing.
+ *
+ * @param value [the compare value]
+ */
+static void smc_cpu_mtimecmp_write(smc_uint64_t value)
+{
+	smc_mem_write_32(CLINT_MTIMECMP_HI, 0xFFFFFFFF);
+	smc_mem_write_32(CLINT_MTIMECMP_LO, (smc_uint32_t)value);
+	smc_mem_write_32(CLINT_MTIMECMP_HI, (smc_uint32_t)(value >> 32));
+}
+
+/**
+ * The machine timer interrupt handler, it will make the next tick and
+ * feed smc_time_tick(). The compare value is added by a fixed interval, so
+ * the tick will not drift with the interrupt latency.
+ */
+static void smc_cpu_timer_handler(void)
+{
+	smc_cpu_mtimecmp += TICK_INTERVAL;
+	smc_cpu_mtimecmp_write(smc_cpu_mtimecmp);
+
+	/* enter interrupt */
+	smc_enter_interrupt();
+
+	smc_time_tick();
+
+	/* exit interrupt */
+	smc_exit_interrupt();
+}
+
+/**
+ * This function will be invoked for the machine external interrupt and the
+ * other local interrupts, the board should implement it.
+ *
+ * @param cause [the interrupt cause without interrupt bit]
+ */
+SMC_WEAK void smc_cpu_irq_handler(smc_uint32_t cause)
+{
+}
+
+/**
+ * This function will be invoked for synchronous exceptions, the board can
+ * implement it.
+ *
+ * @param cause [the exception cause]
+ */
+SMC_WEAK void smc_cpu_exception_handler(smc_uint32_t cause)
+{
+	while (1);
+}
+
+#ifdef SMC_USING_SST
+/**
+ * This function will run the pended tasks with higher priority than the
+ * running one on the interrupt stack, with interrupt enabled. The thread
+ * switch is deferred until all the tasks are done.
+ */
+static void smc_cpu_sst_dispatch(void)
+{
+	smc_uint8_t prev = smc_cpu_sst_current;
+	smc_uint8_t priority;
+	void *sp;
+
+	/* the first thread isn't running, the tasks wait for the next trap */
+	if (smc_thread_current == NULL) {
+		if (smc_cpu_sst_pending != 0U)
+			smc_mem_write_32(CLINT_MSIP, 1);
+		return;
+	}
+
+	while (smc_cpu_sst_pending != 0U) {
+		priority = smc_bit_search(smc_cpu_sst_pending);
+		if (priority >= prev)
+			break;
+
+		smc_cpu_sst_pending &= ~(1U << priority);
+		smc_cpu_sst_current = priority;
+
+		/* the nested trap saves its frame on the interrupt stack to the current thread */
+		sp = smc_thread_current->sp;
+
+		/* enable interrupt, higher task and interrupt can preempt it */
+		__asm__ volatile ("csrs mstatus, %0" : : "r"(MSTATUS_MIE) : "memory");
+
+		smc_enter_interrupt();
+		smc_sst_isr(priority);
+		smc_exit_interrupt();
+
+		/* disable interrupt */
+		__asm__ volatile ("csrc mstatus, %0" : : "r"(MSTATUS_MIE) : "memory");
+
+		smc_thread_current->sp = sp;
+		smc_cpu_sst_current    = prev;
+	}
+}
+#endif
+
+/**
+ * This function will dispatch the trap, it is invoked by smc_trap_entry
+ * with interrupt disabled.
+ *
+ * @param mcause [the machine trap cause]
+ */
+void smc_cpu_trap_handler(smc_uint32_t mcause)
+{
+	switch (mcause) {
+	case MCAUSE_M_SOFT:
+		/* clear software interrupt and make contex switch */
+		smc_mem_write_32(CLINT_MSIP, 0);
+#ifdef SMC_USING_SST
+		smc_cpu_sst_dispatch();
+		if (!smc_cpu_switch_pending || smc_cpu_sst_current != SMC_SST_PRIORITY_MAX)
+			break;
+		smc_cpu_switch_pending = 0;
+#endif
+		smc_thread_current = smc_thread_ready;
+#ifdef SMC_USING_WAKEUP_LATENCY
+		smc_latency_switch_in(smc_thread_current);
+#endif
+		break;
+	case MCAUSE_M_TIMER:
+		smc_cpu_timer_handler();
+		break;
+	default:
+		if (mcause & MCAUSE_INT)
+			smc_cpu_irq_handler(mcause & ~MCAUSE_INT);
+		else
+			smc_cpu_exception_handler(mcause);
+		break;
+	}
+}
+
+/**
+ * This function will initialize thread stack
+ *
+ * @param tentry     [the entry of thread]
+ * @param parameter  [the parameter of entry]
+ * @param stack_addr [the beginning stack address]
+ *
+ * @return           [stack address]
+ */
+smc_stack_t *smc_thread_stack_init(void (*entry)(void *parameter),
+                                   void *parameter,
+                                   smc_stack_t *stack_addr)
+{
+	smc_uint8_t i;
+
+	/* Align the stack to 16-bytes */
+	stack_addr = (smc_stack_t *)SMC_ALIGN_DOWN((smc_stack_t)stack_addr, 16);
+	stack_addr -= FRAME_WORDS;
+
+	for (i = 0; i < FRAME_WORDS; i++)
+		stack_addr[i] = (smc_stack_t)0;
+
+	stack_addr[FRAME_MEPC]    = (smc_stack_t)entry;                        /* mepc		*/
+	stack_addr[FRAME_MSTATUS] = (smc_stack_t)(MSTATUS_MPP_M | MSTATUS_MPIE); /* mstatus	*/
+	stack_addr[FRAME_A0]      = (smc_stack_t)parameter;                    /* a0 : argument	*/
+
+	return stack_addr;
+}
+
+/**
+ * This function will make context switch.
+ *
+ * @note [switch not in interrupt]
+ *
+ */
+void smc_thread_switch(void)
+{
+#ifdef SMC_USING_SST
+	smc_cpu_switch_pending = 1;
+#endif
+	smc_mem_write_32(CLINT_MSIP, 1);
+}
+
+/**
+ * This function will make context switch.
+ *
+ * @note [switch in interrupt]
+ *
+ */
+void smc_thread_intrrupt_switch(void)
+{
+#ifdef SMC_USING_SST
+	smc_cpu_switch_pending = 1;
+#endif
+	smc_mem_write_32(CLINT_MSIP, 1);
+}
+
+/**
+ * This function will perform one schedule. It will select one thread
+ * with the highest priority level, then switch to it. It only for the
+ * first context switch
+ */
+void smc_thread_switch_to(void)
+{
+	/* the main stack is never returned to, it becomes the interrupt stack */
+	__asm__ volatile ("csrw mscratch, sp");
+	__asm__ volatile ("csrw mtvec, %0" : : "r"(smc_trap_entry));
+
+	/* startup the tick */
+	smc_cpu_mtimecmp = smc_cpu_mtime_read() + TICK_INTERVAL;
+	smc_cpu_mtimecmp_write(smc_cpu_mtimecmp);
+
+	__asm__ volatile ("csrs mie, %0" : : "r"(MIE_MSIE | MIE_MTIE));
+#ifdef SMC_USING_SST
+	smc_cpu_switch_pending = 1;
+#endif
+	smc_mem_write_32(CLINT_MSIP, 1);
+
+	/*
+	 * enable interrupt because the interrupt has been diasble
+	 * before the system starts.
+	 */
+	__asm__ volatile ("csrs mstatus, %0" : : "r"(MSTATUS_MIE) : "memory");
+}
+
+/**
+ * This function will return current system interrupt status and disable system
+ * interrupt.
+ *
+ * @return [the current system interrupt status]
+ */
+smc_uint32_t smc_cpu_disable_interrupt(void)
+{
+	smc_uint32_t status;
+
+	__asm__ volatile ("csrrci %0, mstatus, %1" : "=r"(status) : "i"(MSTATUS_MIE) : "memory");
+
+	return status;
+}
+
+/**
+ * This function will set the specified interrupt status, which shall saved by
+ * smc_cpu_disable_interrupt function. If the saved interrupt status is interrupt
+ * opened, this function will open system interrupt status.
+ */
+void smc_cpu_enable_interrupt(smc_uint32_t status)
+{
+	__asm__ volatile ("csrs mstatus, %0" : : "r"(status & MSTATUS_MIE) : "memory");
+}
+
+/**
+ * This function will disable an external interrupt in PLIC
+ *
+ * @param irq [the interrupt source]
+ */
+void smc_cpu_irq_mask(smc_uint32_t irq)
+{
+	smc_uint32_t status = smc_cpu_disable_interrupt();
+
+	smc_mem_write_32(PLIC_ENABLE(irq),
+	                 smc_mem_read_32(PLIC_ENABLE(irq)) & ~(1U << (irq & 0x1F)));
+	smc_cpu_enable_interrupt(status);
+}
+
+/**
+ * This function will enable an external interrupt in PLIC
+ *
+ * @param irq [the interrupt source]
+ */
+void smc_cpu_irq_unmask(smc_uint32_t irq)
+{
+	smc_uint32_t status = smc_cpu_disable_interrupt();
+
+	smc_mem_write_32(PLIC_ENABLE(irq),
+	                 smc_mem_read_32(PLIC_ENABLE(irq)) | (1U << (irq & 0x1F)));
+	smc_cpu_enable_interrupt(status);
+}
+
+#ifdef SMC_USING_SST
+/**
+ * This function will set up a task priority, nothing is needed because
+ * the task levels are kept by software.
+ *
+ * @param priority [the task priority]
+ */
+void smc_hw_sst_enable(smc_uint8_t priority)
+{
+}
+
+/**
+ * This function will pend a task priority on the machine software
+ * interrupt, a higher task preempts the caller as soon as the interrupt is
+ * enabled.
+ *
+ * @param priority [the task priority]
+ */
+void smc_hw_sst_trigger(smc_uint8_t priority)
+{
+	smc_uint32_t status = smc_cpu_disable_interrupt();
+
+	smc_cpu_sst_pending |= 1U << priority;
+	smc_mem_write_32(CLINT_MSIP, 1);
+	smc_cpu_enable_interrupt(status);
+}
+#endif
+
+/**
+ * This function will make cpu sleep until an interrupt is pending, it can
+ * be waked even if mstatus.MIE is cleared.
+ */
+void smc_cpu_wait_for_interrupt(void)
+{
+	__asm__ volatile ("wfi");
+}
+
+/**
+ * This function will return the free-running cpu cycle counter.
+ *
+ * @return [the mcycle counter]
+ */
+smc_uint32_t smc_cpu_cycle_get(void)
+{
+	smc_uint32_t cycle;
+
+	__asm__ volatile ("csrr %0, mcycle" : "=r"(cycle));
+
+	return cycle;
+}
+
+/**
+ * This function will return how many cpu cycles are there in a microsecond.
+ * The core clock is unknown for the port, so mcycle is calibrated against
+ * mtime for 10ms at the first call.
+ *
+ * @return [the cycles of a microsecond]
+ */
+smc_uint32_t smc_cpu_cycles_per_us(void)
+{
+	static smc_uint32_t cycles_per_us;
+
+	if (cycles_per_us == 0U) {
+		smc_uint32_t cycle = smc_cpu_cycle_get();
+
+		smc_cpu_us_delay(10000);
+		cycle = (smc_cpu_cycle_get() - cycle) / 10000;
+		cycles_per_us = cycle ? cycle : 1;
+	}
+
+	return cycles_per_us;
+}
+
+/**
+ * This function will delay some microseconds(us).
+ *
+ * @param us [Delay time]
+ */
+void smc_cpu_us_delay(smc_uint32_t us)
+{
+	smc_uint32_t start = smc_mem_read_32(CLINT_MTIME_LO);
+	smc_uint32_t count = (smc_uint32_t)((smc_uint64_t)us * SMC_CPU_MTIME_HZ / 1000000);
+
+	while (smc_mem_read_32(CLINT_MTIME_LO) - start < count);
+}
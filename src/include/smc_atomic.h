@@ -0,0 +1,156 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-13
+ * Describe: This is a part of SMC-RTOS for atomic operations. The kernel
+ *           fast paths use them to avoid disabling interrupt.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_ATOMIC_H
+#define SMC_ATOMIC_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The exclusive monitor (or reservation) is cleared on exception entry and
+ * exit, so a store-exclusive fails if anything runs between it and the
+ * load-exclusive, even if that code only disables interrupt and stores.
+ */
+#if defined(__CC_ARM)                   /* Cortex-M3/M4: LDREX/STREX */
+
+#define smc_atomic_load_ex(addr)            __ldrex(addr)
+#define smc_atomic_store_ex(addr, value)    __strex(value, addr)
+#define smc_atomic_clear_ex()               __clrex()
+
+#define SMC_ATOMIC_BITBAND_CPU
+
+#elif defined(__GNUC__) && (defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__))
+
+smc_inline smc_uint32_t smc_atomic_load_ex(volatile smc_uint32_t *addr)
+{
+	smc_uint32_t value;
+
+	__asm__ volatile ("ldrex %0, [%1]" : "=r"(value) : "r"(addr) : "memory");
+
+	return value;
+}
+
+smc_inline smc_uint32_t smc_atomic_store_ex(volatile smc_uint32_t *addr, smc_uint32_t value)
+{
+	smc_uint32_t result;
+
+	__asm__ volatile ("strex %0, %2, [%1]" : "=&r"(result) : "r"(addr), "r"(value) : "memory");
+
+	return result;
+}
+
+smc_inline void smc_atomic_clear_ex(void)
+{
+	__asm__ volatile ("clrex" : : : "memory");
+}
+
+#define SMC_ATOMIC_BITBAND_CPU
+
+#elif defined(__GNUC__) && defined(__riscv_atomic)  /* RISC-V: LR/SC */
+
+smc_inline smc_uint32_t smc_atomic_load_ex(volatile smc_uint32_t *addr)
+{
+	smc_uint32_t value;
+
+	__asm__ volatile ("lr.w %0, (%1)" : "=r"(value) : "r"(addr) : "memory");
+
+	return value;
+}
+
+smc_inline smc_uint32_t smc_atomic_store_ex(volatile smc_uint32_t *addr, smc_uint32_t value)
+{
+	smc_uint32_t result;
+
+	__asm__ volatile ("sc.w %0, %2, (%1)" : "=&r"(result) : "r"(addr), "r"(value) : "memory");
+
+	return result;
+}
+
+/* the reservation is invalidated by the trap exit of port */
+#define smc_atomic_clear_ex()
+
+#else
+#error not supported atomic operations
+#endif
+
+/**
+ * @def SMC_BITBAND_SRAM(addr, bit)
+ * Return the bit-band alias address of a bit in SRAM, writing 1 or 0 to
+ * the alias sets or clears the bit atomically.
+ */
+#define SMC_BITBAND_SRAM(addr, bit) \
+	(0x22000000 + (((smc_uint32_t)(addr) & 0x000FFFFF) << 5) + ((bit) << 2))
+
+/**
+ * This function will add a value to the specified address atomically.
+ *
+ * @param addr  [the address]
+ * @param value [the value to be added]
+ *
+ * @return      [the new value]
+ */
+smc_inline smc_uint32_t smc_atomic_add(volatile smc_uint32_t *addr, smc_uint32_t value)
+{
+	smc_uint32_t result;
+
+	do {
+		result = smc_atomic_load_ex(addr) + value;
+	} while (smc_atomic_store_ex(addr, result) != 0U);
+
+	return result;
+}
+
+/**
+ * This function will set a bit of the specified address atomically.
+ *
+ * @param addr [the address]
+ * @param bit  [the bit number]
+ */
+smc_inline void smc_atomic_set_bit(volatile smc_uint32_t *addr, smc_uint8_t bit)
+{
+#if defined(SMC_ATOMIC_BITBAND_CPU) && defined(SMC_USING_BITBAND)
+	smc_mem_write_32(SMC_BITBAND_SRAM(addr, bit), 1);
+#else
+	smc_uint32_t value;
+
+	do {
+		value = smc_atomic_load_ex(addr) | (1U << bit);
+	} while (smc_atomic_store_ex(addr, value) != 0U);
+#endif
+}
+
+/**
+ * This function will clear a bit of the specified address atomically.
+ *
+ * @param addr [the address]
+ * @param bit  [the bit number]
+ */
+smc_inline void smc_atomic_clear_bit(volatile smc_uint32_t *addr, smc_uint8_t bit)
+{
+#if defined(SMC_ATOMIC_BITBAND_CPU) && defined(SMC_USING_BITBAND)
+	smc_mem_write_32(SMC_BITBAND_SRAM(addr, bit), 0);
+#else
+	smc_uint32_t value;
+
+	do {
+		value = smc_atomic_load_ex(addr) & ~(1U << bit);
+	} while (smc_atomic_store_ex(addr, value) != 0U);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_ATOMIC_H
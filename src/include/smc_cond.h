@@ -0,0 +1,77 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-20
+ * Describe: This is a part of SMC-RTOS for condition variable
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_COND_H
+#define SMC_COND_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_COND
+
+#ifndef SMC_USING_SEMAPHORE
+#error condition variable needs SMC_USING_SEMAPHORE for mutex
+#endif
+
+/**
+ * condition variable wait mode
+ */
+#define SMC_COND_WAIT_FOREVER           -1
+#define SMC_COND_NO_WAIT                 0
+
+/**
+ * This function will initialize a condition variable
+ *
+ * @param cond   [the condition variable]
+ * @param policy [the wait queue policy of the suspended threads]
+ */
+void smc_cond_init(smc_cond_t *cond, smc_uint8_t policy);
+
+/**
+ * This function will release the mutex and wait for the condition atomically,
+ * and the mutex is taken again before return, even if time out. The mutex
+ * is kept and -SMC_TIMEOUT is returned at once with SMC_COND_NO_WAIT.
+ *
+ * @param cond     [the condition variable]
+ * @param mutex    [the binary semaphore used as mutex, held by caller]
+ * @param time_out [the waiting time]
+ *
+ * @return         [error number]
+ */
+smc_int32_t smc_cond_wait(smc_cond_t *cond, smc_sem_t *mutex, smc_int32_t time_out);
+
+/**
+ * This function will wake up the first thread waiting for the condition
+ *
+ * @param cond [the condition variable]
+ *
+ * @return     [error number]
+ */
+smc_int32_t smc_cond_signal(smc_cond_t *cond);
+
+/**
+ * This function will wake up all the threads waiting for the condition, and
+ * schedule only once.
+ *
+ * @param cond [the condition variable]
+ *
+ * @return     [error number]
+ */
+smc_int32_t smc_cond_broadcast(smc_cond_t *cond);
+
+#endif /* SMC_USING_COND */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_COND_H
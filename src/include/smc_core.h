@@ -11,26 +11,39 @@
 #define SMC_CORE_H
 
 #include "smc_def.h"
+#include "smc_atomic.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-extern smc_uint32_t smc_bitmap_group;                     /* thread priority bit map */
+extern volatile smc_uint32_t smc_bitmap_group;            /* thread priority bit map */
+
+#define SMC_US_PER_TICK           (1000000U / SMC_TICKS_PER_SECOND)  /* microseconds of a tick */
 
 /**
- * The function will set a bit according to thread priority
+ * The function will set a bit according to thread priority atomically
  *
  * @param prio [the thread priority]
  */
-#define smc_bitmap_set(prio)      (smc_bitmap_group |= (1 << prio))
+#define smc_bitmap_set(prio)      smc_atomic_set_bit(&smc_bitmap_group, prio)
 
 /**
- * The function will clear a bit according to thread priority
+ * The function will clear a bit according to thread priority atomically
  *
  * @param prio [the thread priority]
  */
-#define smc_bitmap_clear(prio)    (smc_bitmap_group &= ~(1 << prio))
+#define smc_bitmap_clear(prio)    smc_atomic_clear_bit(&smc_bitmap_group, prio)
+
+/**
+ * The function will find the first bit set (beginning with the least
+ * significant bit) in value.
+ *
+ * @param value [the value to be searched]
+ *
+ * @return      [the index of the first bit set, 0 if value is 0]
+ */
+smc_uint8_t smc_bit_search(smc_uint32_t value);
 
 /**
  * The function will get the highest priority
@@ -43,12 +56,42 @@ smc_uint8_t smc_get_highest_prio(void);
  */
 void smc_time_tick(void);
 
+/**
+ * This function will return the ticks since system startup
+ *
+ * @return  [the current tick]
+ */
+smc_uint32_t smc_tick_get(void);
+
+#if defined(SMC_USING_THREAD_STATS) || defined(SMC_USING_PM) || defined(SMC_USING_WAKEUP_LATENCY)
+/**
+ * This function will return the current tick and the cpu cycle when it
+ * started.
+ *
+ * @param cycle [the cpu cycle of the tick interrupt]
+ *
+ * @return      [the current tick]
+ */
+smc_uint32_t smc_tick_get_stamp(smc_uint32_t *cycle);
+#endif
+
 /**
  * This function will perform one schedule. It will select one thread
- * with the highest priority level, then switch to it.
+ * with the highest priority level, then switch to it. In interrupt service
+ * routine, it only marks that a reschedule is needed, and the decision is
+ * made once by smc_exit_interrupt().
  */
 void smc_scheduler(void);
 
+/**
+ * This function will return whether the current context can be blocked. It
+ * can't be blocked in interrupt, before scheduler startup and with scheduler
+ * locked.
+ *
+ * @return  [1 on blockable, 0 on not]
+ */
+smc_bool_t smc_scheduler_is_blockable(void);
+
 /**
  * This function will init SMC-RTOS
  */
@@ -78,7 +121,9 @@ void smc_scheduler_sethook(void (*hook)(void));
 void smc_enter_interrupt(void);
 
 /**
- * This function will be invoked by BSP, when leave interrupt service routine
+ * This function will be invoked by BSP, when leave interrupt service routine.
+ * The outermost interrupt will reschedule if any kernel call in interrupt
+ * needs it.
  *
  * @note [please don't invoke this routine in application]
  *
@@ -0,0 +1,506 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-28
+ * Describe: This is a part of SMC-RTOS for C++20 coroutine, many stackless
+ *           tasks run on one executor thread and their frames are allocated
+ *           from a fixed pool.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_CORO_HPP
+#define SMC_CORO_HPP
+
+#if __cplusplus < 202002L
+#error SMC-RTOS coroutine needs C++20 or later
+#endif
+
+#include <coroutine>
+#include <cstddef>
+#include "smc_rtos.h"
+#include "smc_guard.hpp"
+
+#ifndef SMC_USING_SEMAPHORE
+#error coroutine executor needs SMC_USING_SEMAPHORE
+#endif
+
+namespace smc {
+
+class Executor;
+
+/**
+ * The coroutine frame pool, all the frames have the same size
+ */
+class FramePool {
+public:
+	/**
+	 * This function will allocate a frame
+	 *
+	 * @param size [the frame size required by compiler]
+	 *
+	 * @return     [the frame, nullptr if the pool is empty or size is too big]
+	 */
+	static void *alloc(std::size_t size) noexcept
+	{
+		CriticalSection cs;
+		Block *block;
+
+		if (size > SMC_CORO_FRAME_SIZE)
+			return nullptr;
+
+		if (!inited_) {
+			for (smc_uint32_t i = 0; i < SMC_CORO_FRAME_MAX; i++) {
+				blocks_[i].next = free_;
+				free_           = &blocks_[i];
+			}
+			inited_ = true;
+		}
+
+		block = free_;
+		if (block)
+			free_ = block->next;
+
+		return block;
+	}
+
+	/**
+	 * This function will free a frame to pool
+	 *
+	 * @param frame [the frame]
+	 */
+	static void free(void *frame) noexcept
+	{
+		CriticalSection cs;
+		Block *block = static_cast<Block *>(frame);
+
+		block->next = free_;
+		free_       = block;
+	}
+
+private:
+	union alignas(8) Block {
+		Block *next;
+		smc_uint8_t frame[SMC_CORO_FRAME_SIZE];
+	};
+
+	static inline Block blocks_[SMC_CORO_FRAME_MAX];
+	static inline Block *free_;
+	static inline bool inited_;
+};
+
+/**
+ * The coroutine task, it's spawned to an executor and never awaited by the
+ * other task. The frame is freed when the task returns.
+ */
+class Task {
+public:
+	struct promise_type {
+		smc_list_node_t rlist;                    /* executor ready list node */
+		Executor *executor = nullptr;
+
+		static void *operator new(std::size_t size) noexcept
+		{
+			return FramePool::alloc(size);
+		}
+
+		static void operator delete(void *frame) noexcept
+		{
+			FramePool::free(frame);
+		}
+
+		static Task get_return_object_on_allocation_failure() noexcept
+		{
+			return Task(nullptr);
+		}
+
+		Task get_return_object() noexcept
+		{
+			return Task(handle::from_promise(*this));
+		}
+
+		std::suspend_always initial_suspend() noexcept
+		{
+			return {};
+		}
+
+		std::suspend_never final_suspend() noexcept
+		{
+			return {};
+		}
+
+		void return_void() noexcept
+		{
+		}
+
+		void unhandled_exception() noexcept
+		{
+			while (1);
+		}
+	};
+
+	using handle = std::coroutine_handle<promise_type>;
+
+	explicit Task(handle coro) noexcept
+		: coro_(coro)
+	{
+	}
+
+	explicit Task(std::nullptr_t) noexcept
+		: coro_(nullptr)
+	{
+	}
+
+private:
+	friend class Executor;
+
+	handle coro_;
+};
+
+/**
+ * The executor runs the ready tasks one by one on its thread. The thread is
+ * defined by user, e.g.
+ *
+ *   static smc::Executor exec;
+ *   static smc::Thread<1024, 4, smc::Executor::entry> exec_thread(&exec);
+ */
+class Executor {
+public:
+	constexpr Executor() noexcept
+	{
+	}
+
+	Executor(const Executor &) = delete;
+	Executor &operator=(const Executor &) = delete;
+
+	/**
+	 * This function will initialize the executor, it should be invoked
+	 * before its thread and any task starts.
+	 */
+	void start() noexcept
+	{
+		smc_list_node_init(&ready_);
+		smc_sem_init_policy(&wake_, 0, SMC_WAITQ_FIFO);
+	}
+
+	/**
+	 * This function will spawn a task to executor
+	 *
+	 * @param task [the task]
+	 *
+	 * @return     [SMC_OK on success, -SMC_NOMEM if no frame for task]
+	 */
+	smc_int32_t spawn(Task task) noexcept
+	{
+		if (!task.coro_)
+			return -SMC_NOMEM;
+
+		task.coro_.promise().executor = this;
+		schedule(task.coro_);
+
+		return SMC_OK;
+	}
+
+	/**
+	 * This function will put a suspended task to ready list, it can be
+	 * invoked in interrupt handle.
+	 *
+	 * @param coro [the suspended task]
+	 */
+	void schedule(Task::handle coro) noexcept
+	{
+		{
+			CriticalSection cs;
+
+			smc_list_add_tail(&coro.promise().rlist, &ready_);
+		}
+		smc_sem_release(&wake_);
+	}
+
+	/**
+	 * The entry function of executor thread
+	 *
+	 * @param parameter [the executor]
+	 */
+	static void entry(void *parameter)
+	{
+		static_cast<Executor *>(parameter)->run();
+	}
+
+private:
+	void run() noexcept
+	{
+		while (1) {
+			Task::promise_type *promise;
+
+			smc_sem_pend(&wake_, SMC_SEM_WAIT_FOREVER);
+
+			{
+				CriticalSection cs;
+
+				promise = smc_list_entry(ready_.next, Task::promise_type, rlist);
+				smc_list_del_entry(&promise->rlist);
+			}
+
+			Task::handle::from_promise(*promise).resume();
+		}
+	}
+
+	smc_list_head_t ready_{};
+	smc_sem_t wake_{};
+};
+
+/**
+ * The awaiter to suspend the task for some ticks
+ */
+class Delay {
+public:
+	explicit Delay(smc_uint32_t tick) noexcept
+		: tick_(tick)
+	{
+	}
+
+	bool await_ready() const noexcept
+	{
+		return tick_ == 0;
+	}
+
+	void await_suspend(Task::handle coro) noexcept
+	{
+		coro_ = coro;
+		smc_timer_init(&timer_, tick_, timeout, this, SMC_TIMER_ONCE);
+		smc_timer_enable(&timer_);
+	}
+
+	void await_resume() const noexcept
+	{
+	}
+
+private:
+	static void timeout(void *parameter)
+	{
+		Delay *delay = static_cast<Delay *>(parameter);
+
+		delay->coro_.promise().executor->schedule(delay->coro_);
+	}
+
+	smc_timer_t timer_;
+	smc_uint32_t tick_;
+	Task::handle coro_;
+};
+
+/**
+ * This function will return an awaiter to suspend the task for some ticks
+ *
+ * @param tick [the delay ticks]
+ */
+inline Delay delay(smc_uint32_t tick) noexcept
+{
+	return Delay(tick);
+}
+
+#ifdef SMC_USING_WAITSET
+/**
+ * The awaiter to take a semaphore. The task polls the semaphore, and the
+ * semaphore is taken in the release path, so the task never loses it after
+ * waked.
+ */
+class SemTake {
+public:
+	SemTake(smc_sem_t *sem, smc_int32_t time_out) noexcept
+		: sem_(sem), time_out_(time_out)
+	{
+	}
+
+	bool await_ready() noexcept
+	{
+		error_num_ = smc_sem_try_take(sem_);
+
+		return error_num_ == SMC_OK || time_out_ == SMC_SEM_NO_WAIT;
+	}
+
+	bool await_suspend(Task::handle coro) noexcept
+	{
+		CriticalSection cs;
+
+		/* the semaphore may be released before interrupt disabled */
+		error_num_ = smc_sem_try_take(sem_);
+		if (error_num_ == SMC_OK)
+			return false;
+
+		coro_        = coro;
+		node_.notify = notify;
+		smc_list_add_tail(&node_.plist, &sem_->plist);
+
+		smc_timer_init(&timer_, time_out_, timeout, this, SMC_TIMER_DISABLE);
+		if (time_out_ > 0) {
+			smc_uint8_t flag = SMC_TIMER_ONCE;
+
+			smc_timer_command(&timer_, SMC_TIMER_SET_OPERATION_MODE, &flag);
+			smc_timer_enable(&timer_);
+		}
+
+		return true;
+	}
+
+	smc_int32_t await_resume() const noexcept
+	{
+		return error_num_;
+	}
+
+private:
+	/* it's invoked with interrupt disabled by smc_sem_release() */
+	static void notify(smc_poll_node_t *node)
+	{
+		SemTake *take = smc_list_entry(node, SemTake, node_);
+
+		/* the other poller may take it first */
+		if (smc_sem_try_take(take->sem_) == SMC_OK)
+			take->finish(SMC_OK);
+	}
+
+	/* it's invoked with interrupt disabled by timer tick */
+	static void timeout(void *parameter)
+	{
+		static_cast<SemTake *>(parameter)->finish(-SMC_TIMEOUT);
+	}
+
+	void finish(smc_int32_t error_num) noexcept
+	{
+		smc_list_del_entry(&node_.plist);
+		smc_timer_disable(&timer_);
+		error_num_ = error_num;
+		coro_.promise().executor->schedule(coro_);
+	}
+
+	smc_poll_node_t node_;                        /* poll node linked to semaphore */
+	smc_sem_t *sem_;
+	smc_int32_t time_out_;
+	smc_int32_t error_num_ = SMC_OK;
+	smc_timer_t timer_;
+	Task::handle coro_;
+};
+
+/**
+ * This function will return an awaiter to take a semaphore, the result of
+ * co_await is the error number.
+ *
+ * @param sem      [the semaphore]
+ * @param time_out [the waiting time]
+ */
+inline SemTake take(smc_sem_t *sem,
+                    smc_int32_t time_out = SMC_SEM_WAIT_FOREVER) noexcept
+{
+	return SemTake(sem, time_out);
+}
+#endif /* SMC_USING_WAITSET */
+
+/**
+ * Periodic timer for tasks, the result of co_await next() is the number of
+ * periods expired since the last await.
+ */
+class Periodic {
+public:
+	class Awaiter {
+	public:
+		explicit Awaiter(Periodic *periodic) noexcept
+			: periodic_(periodic)
+		{
+		}
+
+		bool await_ready() noexcept
+		{
+			CriticalSection cs;
+
+			return take();
+		}
+
+		bool await_suspend(Task::handle coro) noexcept
+		{
+			CriticalSection cs;
+
+			if (take())
+				return false;
+
+			periodic_->waiter_ = coro;
+			return true;
+		}
+
+		smc_uint32_t await_resume() noexcept
+		{
+			/* waked by timer, take the expired periods */
+			if (expired_ == 0) {
+				CriticalSection cs;
+
+				take();
+			}
+
+			return expired_;
+		}
+
+	private:
+		bool take() noexcept
+		{
+			expired_            = periodic_->expired_;
+			periodic_->expired_ = 0;
+
+			return expired_ != 0;
+		}
+
+		Periodic *periodic_;
+		smc_uint32_t expired_ = 0;
+	};
+
+	constexpr Periodic() noexcept
+	{
+	}
+
+	Periodic(const Periodic &) = delete;
+	Periodic &operator=(const Periodic &) = delete;
+
+	/**
+	 * This function will start the periodic timer
+	 *
+	 * @param period [the ticks of period]
+	 */
+	void start(smc_uint32_t period) noexcept
+	{
+		smc_timer_disable(&timer_);
+		expired_ = 0;
+		waiter_  = nullptr;
+		smc_timer_init(&timer_, period, timeout, this, SMC_TIMER_PERIODIC);
+		smc_timer_enable(&timer_);
+	}
+
+	void stop() noexcept
+	{
+		smc_timer_disable(&timer_);
+	}
+
+	Awaiter next() noexcept
+	{
+		return Awaiter(this);
+	}
+
+private:
+	static void timeout(void *parameter)
+	{
+		Periodic *periodic = static_cast<Periodic *>(parameter);
+
+		periodic->expired_++;
+		if (periodic->waiter_) {
+			Task::handle coro = periodic->waiter_;
+
+			periodic->waiter_ = nullptr;
+			coro.promise().executor->schedule(coro);
+		}
+	}
+
+	smc_timer_t timer_{};
+	smc_uint32_t expired_ = 0;
+	Task::handle waiter_{};
+};
+
+} // namespace smc
+
+#endif // SMC_CORO_HPP
@@ -31,6 +31,18 @@ smc_uint32_t smc_cpu_disable_interrupt(void);
  */
 void smc_cpu_enable_interrupt(smc_uint32_t status);
 
+#if defined(SMC_USING_IRQOFF_PROFILE) && !defined(SMC_CPU_PORT)
+/**
+ * The profiled critical section, the call site is recorded when interrupt is
+ * disabled. The port defines SMC_CPU_PORT to implement the original functions.
+ */
+smc_uint32_t smc_irqoff_enter(const char *file, smc_uint32_t line);
+void smc_irqoff_exit(smc_uint32_t status);
+
+#define smc_cpu_disable_interrupt()       smc_irqoff_enter(__FILE__, __LINE__)
+#define smc_cpu_enable_interrupt(status)  smc_irqoff_exit(status)
+#endif
+
 /**
  * This function will initialize thread stack
  *
@@ -73,6 +85,87 @@ void smc_thread_switch_to(void);
  */
 void smc_cpu_us_delay(smc_uint32_t us);
 
+/**
+ * This function will disable an external interrupt in interrupt controller
+ *
+ * @param irq [the interrupt number]
+ */
+void smc_cpu_irq_mask(smc_uint32_t irq);
+
+/**
+ * This function will enable an external interrupt in interrupt controller
+ *
+ * @param irq [the interrupt number]
+ */
+void smc_cpu_irq_unmask(smc_uint32_t irq);
+
+/**
+ * This function will make cpu sleep until an interrupt is pending, it can
+ * be waked even if interrupt is disabled.
+ */
+void smc_cpu_wait_for_interrupt(void);
+
+/**
+ * This function will return the free-running cpu cycle counter.
+ *
+ * @return [the cycle counter]
+ */
+smc_uint32_t smc_cpu_cycle_get(void);
+
+/**
+ * This function will return how many cpu cycles are there in a microsecond.
+ *
+ * @return [the cycles of a microsecond]
+ */
+smc_uint32_t smc_cpu_cycles_per_us(void);
+
+#ifdef SMC_USING_HRTIMER
+/**
+ * This function will return the free-running high-resolution counter, which
+ * counts up at SMC_HRTIMER_COUNTER_HZ and wraps at 32bit.
+ *
+ * @return [the counter value]
+ */
+smc_uint32_t smc_hw_hrtimer_read(void);
+
+/**
+ * This function will arm the compare channel of the high-resolution counter,
+ * smc_hrtimer_isr() should be invoked when the counter reaches the value.
+ *
+ * @param count [the compare value]
+ *
+ * @note        [if the counter has passed the value already, the compare]
+ * interrupt must be pended, or the expiry will be lost.
+ */
+void smc_hw_hrtimer_set_compare(smc_uint32_t count);
+#endif
+
+#ifdef SMC_USING_SST
+/**
+ * This function will set up the software interrupt of a run-to-completion
+ * task priority. The interrupts of tasks are below all the other interrupts
+ * but above the thread switch, and a higher task has a higher interrupt
+ * priority.
+ *
+ * @param priority [the task priority]
+ */
+void smc_hw_sst_enable(smc_uint8_t priority);
+
+/**
+ * This function will pend the software interrupt of a task priority, its
+ * handler should invoke smc_sst_isr() with the priority.
+ *
+ * @param priority [the task priority]
+ */
+void smc_hw_sst_trigger(smc_uint8_t priority);
+
+/**
+ * The software interrupt handler of all the task priorities on Cortex-M,
+ * BSP puts it to the vectors of the interrupts from SMC_SST_IRQ_BASE.
+ */
+void smc_sst_irq_handler(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -39,6 +39,8 @@ typedef signed   int                    smc_int32_t;     /* 32bit integer type *
 typedef unsigned char                   smc_uint8_t;     /*  8bit unsigned integer type */
 typedef unsigned short                  smc_uint16_t;    /* 16bit unsigned integer type */
 typedef unsigned int                    smc_uint32_t;    /* 32bit unsigned integer type */
+typedef signed   long long              smc_int64_t;     /* 64bit integer type */
+typedef unsigned long long              smc_uint64_t;    /* 64bit unsigned integer type */
 typedef int                             smc_bool_t;      /* boolean type */
 
 /* 32bit CPU */
@@ -61,6 +63,15 @@ typedef smc_uint32_t                    smc_stack_t;     /* cpu stack type */
 	#define SMC_USED                    __attribute__((used))
 	#define SMC_WEAK                    __weak
 	#define smc_inline                   static __inline
+	#define smc_barrier()               __schedule_barrier()
+#elif defined(__GNUC__)                 /* GNU GCC Compiler */
+	#include <stdarg.h>
+	#define SMC_SECTION(x)              __attribute__((section(x)))
+	#define SMC_UNUSED                  __attribute__((unused))
+	#define SMC_USED                    __attribute__((used))
+	#define SMC_WEAK                    __attribute__((weak))
+	#define smc_inline                   static __inline
+	#define smc_barrier()               __asm__ volatile ("" : : : "memory")
 #else
 	#error not supported tool chain
 #endif
@@ -104,6 +115,8 @@ enum smc_timer_command_e {
 	SMC_TIMER_SET_TIMEOUT_TICK_AFTER,             /* The next timing cycle works */
 	SMC_TIMER_SET_TIMEOUT_TICK_IMMEDIATELY,       /* Immediately works */
 	SMC_TIMER_SET_OPERATION_MODE,
+	SMC_TIMER_SET_SLACK,                          /* The ticks the expiry can be late */
+	SMC_TIMER_SET_DEFERRABLE,                     /* The timer doesn't keep cpu awake */
 };
 
 /* thread state enum */
@@ -114,6 +127,13 @@ enum smc_thread_state_e {
 	SMC_THREAD_DELETE                             /* Delete status */
 };
 
+/* wait queue policy enum */
+enum smc_waitq_policy_e {
+	SMC_WAITQ_PRIO,                               /* the highest priority thread is waked first */
+	SMC_WAITQ_FIFO,                               /* the first suspended thread is waked first */
+	SMC_WAITQ_LIFO                                /* the last suspended thread is waked first */
+};
+
 /**
  * Timer structure
  */
@@ -123,9 +143,43 @@ typedef struct smc_timer {
 	smc_list_node_t tlist;                         /* thread delay list node */
 	smc_uint32_t    init_tick;                     /* init tick */
 	smc_uint32_t    timeout_tick;                  /* timeout tick */
+#ifdef SMC_USING_TIMER_SLACK
+	smc_uint32_t    slack;                         /* the ticks the expiry can be late */
+	smc_uint32_t    late;                          /* the ticks this expiry is delayed by slack */
+	smc_uint8_t     deferrable;                    /* timer doesn't wake up the idle cpu */
+#endif
 	smc_uint8_t     flag;
 } smc_timer_t;
 
+#ifdef SMC_USING_HRTIMER
+/**
+ * High-resolution timer structure
+ */
+typedef struct smc_hrtimer {
+	void (*timeout)(void *parameter);
+	void *parameter;
+	smc_list_node_t hlist;                         /* high-resolution timer list node */
+	smc_uint64_t    expires;                       /* absolute expiry in counter ticks */
+	smc_uint8_t     active;                        /* timer is in timer list */
+} smc_hrtimer_t;
+#endif
+
+#ifdef SMC_USING_THREAD_STATS
+/**
+ * Periodic thread timing statistics, the jitter is from the tick interrupt
+ * of release time to the thread running, in microseconds.
+ */
+typedef struct smc_thread_stats {
+	smc_uint32_t    deadline;                      /* relative deadline ticks, 0 for the period */
+	smc_uint32_t    releases;                      /* the number of periodic releases */
+	smc_uint32_t    overruns;                      /* the release time has passed before delay */
+	smc_uint32_t    deadline_misses;               /* the job is done after deadline */
+	smc_uint32_t    jitter_min;
+	smc_uint32_t    jitter_max;
+	smc_uint32_t    jitter_hist[SMC_THREAD_JITTER_BUCKETS]; /* bucket n counts jitter in [2^(n-1), 2^n) */
+} smc_thread_stats_t;
+#endif
+
 /**
  * Thread structure
  */
@@ -133,6 +187,7 @@ typedef struct smc_thread {
 	/* stack point and entry */
 	void            *sp;                           /* stack point */
 	smc_uint8_t     priority;                      /* thread priotity */
+	smc_uint8_t     init_priority;                 /* init priority, restored after inheritance */
 	smc_uint8_t     stat;                          /* thread state */
 
 	smc_list_node_t rlist;                         /* thread ready list node */
@@ -142,18 +197,323 @@ typedef struct smc_thread {
 	smc_uint32_t    remaining_slice_tick;          /* remaining slice tick */
 
 	smc_int32_t     error_num;                     /* error number */
+#ifdef SMC_USING_THREAD_STATS
+	smc_thread_stats_t stats;                      /* periodic timing statistics */
+#endif
+#ifdef SMC_USING_WAKEUP_LATENCY
+	smc_uint32_t    wake_cycle;                    /* the cpu cycle of becoming ready */
+	smc_uint8_t     wake_pending;                  /* waked but not running yet */
+#endif
+#ifdef SMC_USING_RWLOCK
+	smc_list_head_t rwlock_list;                   /* the reader-writer locks held for writing */
+#endif
 } smc_thread_t;
 
+/**
+ * Wait queue structure, the suspended threads are kept in the waking order.
+ */
+typedef struct smc_waitq {
+	smc_list_head_t wlist;                        /* suspended thread list */
+	smc_uint8_t     policy;                       /* wait queue policy */
+} smc_waitq_t;
+
+#ifdef SMC_USING_WAITSET
+/**
+ * Poll node structure, it's linked to the poll list of a kernel object and
+ * notified when the object becomes available.
+ */
+typedef struct smc_poll_node {
+	smc_list_node_t plist;                        /* poll list node */
+	void (*notify)(struct smc_poll_node *node);   /* invoked with interrupt disabled */
+} smc_poll_node_t;
+
+/**
+ * Wait set entry structure
+ */
+typedef struct smc_waitset_entry {
+	smc_poll_node_t node;                         /* poll node linked to object */
+	void            *object;                      /* the kernel object */
+	smc_list_head_t *head;                        /* the poll list of object */
+	smc_int32_t     (*take)(void *object);        /* take the object without wait */
+	smc_thread_t    *thread;                      /* the waiting thread */
+} smc_waitset_entry_t;
+
+/**
+ * Wait set structure
+ */
+typedef struct smc_waitset {
+	smc_waitset_entry_t entry[SMC_WAITSET_MAX];
+	smc_uint8_t     count;                        /* the number of objects */
+} smc_waitset_t;
+#endif
+
+#ifdef SMC_USING_LOCK_STATS
+/**
+ * Contention statistics of a lock, the blocked time is in cpu cycles
+ */
+typedef struct smc_lockstat {
+	smc_list_node_t list;                         /* node of the registry */
+	const char      *name;
+	volatile smc_uint32_t pends;                  /* how many times the lock is taken */
+	smc_uint32_t    contended;                    /* how many times the lock is unavailable */
+	smc_uint32_t    timeouts;
+	smc_uint32_t    wait_max;
+	smc_uint64_t    wait_sum;
+	smc_thread_t    *wait_max_thread;             /* the thread waited longest */
+} smc_lockstat_t;
+#endif
+
 #ifdef SMC_USING_SEMAPHORE
 /**
  * Semaphore structure
  */
 typedef struct smc_sem {
-	smc_list_head_t slist;                        /* Thread that is suspended for waiting for a semaphore */
-	smc_uint16_t    value;                        /* semaphore value */
+	smc_waitq_t     waitq;                        /* Thread that is suspended for waiting for a semaphore */
+	volatile smc_uint32_t value;                  /* semaphore value, word size for exclusive access */
+#ifdef SMC_USING_WAITSET
+	smc_list_head_t plist;                        /* poll node of wait set waiting for a semaphore */
+#endif
+#ifdef SMC_USING_LOCK_STATS
+	smc_lockstat_t  stats;
+#endif
 } smc_sem_t;
 #endif
 
+#ifdef SMC_USING_COND
+/**
+ * Condition variable structure
+ */
+typedef struct smc_cond {
+	smc_waitq_t     waitq;                        /* Thread that is suspended for waiting for the condition */
+} smc_cond_t;
+#endif
+
+#ifdef SMC_USING_RWLOCK
+/**
+ * Reader-writer lock structure
+ */
+typedef struct smc_rwlock {
+	smc_waitq_t     rwaitq;                       /* Reader that is suspended for waiting for the lock */
+	smc_waitq_t     wwaitq;                       /* Writer that is suspended for waiting for the lock */
+	smc_thread_t    *writer;                      /* the writer holds the lock */
+	smc_list_node_t hlist;                        /* node of the lock list held by writer */
+	smc_uint16_t    readers;                      /* the number of readers hold the lock */
+#ifdef SMC_USING_LOCK_STATS
+	smc_lockstat_t  stats;
+#endif
+} smc_rwlock_t;
+#endif
+
+#ifdef SMC_USING_WORKQUEUE
+/**
+ * Work item state
+ */
+enum smc_work_state_e {
+	SMC_WORK_IDLE,                                /* neither pending nor running */
+	SMC_WORK_DELAYED,                             /* waiting for the timer to submit it */
+	SMC_WORK_QUEUED,                              /* in the pending list of work queue */
+	SMC_WORK_RUNNING,                             /* a worker is running its function */
+	SMC_WORK_REQUEUED                             /* running, queued again when it returns */
+};
+
+/**
+ * Work queue structure, it's served by a pool of worker threads.
+ */
+typedef struct smc_workqueue {
+	smc_list_head_t wlist;                        /* pending work list */
+	smc_sem_t       sem;                          /* the number of pending work */
+} smc_workqueue_t;
+
+/**
+ * Work item structure
+ */
+typedef struct smc_work {
+	smc_list_node_t wlist;                        /* work queue pending list node */
+	void (*func)(void *arg);
+	void            *arg;
+	smc_workqueue_t *wq;                          /* the work queue submitted to */
+	smc_timer_t     timer;                        /* timer for delayed submission */
+	smc_uint8_t     state;
+} smc_work_t;
+#endif
+
+#ifdef SMC_USING_SST
+/**
+ * Run-to-completion task structure, all the tasks share the main stack.
+ */
+typedef struct smc_sst_task {
+	void (*handler)(struct smc_sst_task *task, void *event);
+	void            **queue;                      /* event queue buffer */
+	smc_uint8_t     size;                         /* event queue size */
+	smc_uint8_t     head;                         /* the index of the next event to dispatch */
+	smc_uint8_t     count;                        /* the number of queued events */
+	smc_uint8_t     priority;                     /* 0 is the highest */
+} smc_sst_task_t;
+#endif
+
+#ifdef SMC_USING_PM
+/**
+ * Idle state structure, the statistics are updated by power governor.
+ */
+typedef struct smc_pm_state {
+	/* enter the state until wakeup, return the slept microseconds if the tick is stopped */
+	smc_uint32_t (*enter)(smc_uint32_t sleep_us);
+	smc_uint32_t    exit_latency_us;               /* the time to leave the state */
+	smc_uint32_t    target_residency_us;           /* the shortest stay that saves power */
+	smc_uint8_t     stop_tick;                     /* the tick is stopped in the state */
+
+	smc_uint32_t    entries;                       /* how many times the state is entered */
+	smc_uint64_t    residency_us;                  /* the total time in the state */
+	smc_uint32_t    residency_max_us;
+	smc_uint32_t    wake_latency_max_us;           /* from the tick interrupt or the programmed wakeup */
+} smc_pm_state_t;
+
+/**
+ * Latency constraint structure, the deeper states whose exit latency is
+ * longer than any constraint are vetoed.
+ */
+typedef struct smc_pm_qos {
+	smc_list_node_t qlist;                         /* constraint list node */
+	smc_uint32_t    latency_us;                    /* the max tolerable wakeup latency */
+} smc_pm_qos_t;
+#endif
+
+#ifdef SMC_USING_STREAM
+/**
+ * Byte stream structure, one writer and one reader. The indexes are free
+ * running and each one is only moved by its side.
+ */
+typedef struct smc_stream {
+	smc_uint8_t     *buffer;
+	smc_uint32_t    size;                         /* power of 2 */
+	volatile smc_uint32_t head;                   /* read index, moved by reader */
+	volatile smc_uint32_t tail;                   /* write index, moved by writer */
+	smc_uint32_t    trigger;                      /* how many bytes wake the reader */
+
+	smc_thread_t    *reader;                      /* the suspended reader */
+	smc_uint32_t    reader_wanted;                /* the bytes to wake reader */
+	smc_thread_t    *writer;                      /* the suspended writer */
+	smc_uint32_t    writer_wanted;                /* the free bytes to wake writer */
+} smc_stream_t;
+#endif
+
+#ifdef SMC_USING_PBUF
+/**
+ * Packet buffer structure, the data follows it in the same pool element.
+ * The buffers are chained for a large payload.
+ */
+typedef struct smc_pbuf {
+	struct smc_pbuf *next;                        /* next buffer of chain, or free list */
+	struct smc_pbuf_pool *pool;
+	smc_uint8_t     *payload;                     /* the start of data */
+	smc_uint16_t    len;                          /* data length of this buffer */
+	smc_uint16_t    tot_len;                      /* data length of the chain from this buffer */
+	volatile smc_uint32_t ref;                    /* reference count, word size for exclusive access */
+} smc_pbuf_t;
+
+/**
+ * Packet buffer pool structure
+ */
+typedef struct smc_pbuf_pool {
+	smc_pbuf_t      *free;
+	smc_waitq_t     waitq;                        /* the threads waiting for free buffers */
+	smc_uint16_t    avail;                        /* how many free buffers */
+	smc_uint16_t    buf_size;                     /* data bytes of a buffer */
+	smc_uint16_t    num;                          /* how many buffers */
+} smc_pbuf_pool_t;
+
+/**
+ * Packet buffer queue structure, the free slots and the queued buffers are
+ * counted by two semaphores.
+ */
+typedef struct smc_pbuf_queue {
+	smc_pbuf_t      **slot;
+	smc_uint16_t    size;
+	smc_uint16_t    head;
+	smc_uint16_t    tail;
+	smc_sem_t       slots;
+	smc_sem_t       items;
+} smc_pbuf_queue_t;
+#endif
+
+#ifdef SMC_USING_TOPIC
+/**
+ * Topic structure, the published messages are kept in a history ring and
+ * the sequence counter tells the readers whether a slot is overwritten.
+ */
+typedef struct smc_topic {
+	const char      *name;
+	smc_uint8_t     *history;                     /* depth messages */
+	smc_uint16_t    size;                         /* message size */
+	smc_uint16_t    depth;                        /* power of 2 */
+	volatile smc_uint32_t published;              /* sequence counter, how many messages are published */
+	smc_waitq_t     waitq;                        /* subscribers waiting for update */
+
+	smc_uint32_t    window_start;                 /* the tick of rate window */
+	smc_uint32_t    window_count;                 /* messages published in rate window */
+	smc_uint32_t    rate;                         /* messages per second of the last window */
+	smc_uint32_t    lag_max;                      /* max unread messages seen by subscribers */
+} smc_topic_t;
+
+/**
+ * Subscriber structure, it's owned by one reader.
+ */
+typedef struct smc_subscriber {
+	smc_topic_t     *topic;
+	smc_uint32_t    next;                         /* sequence of the next unread message */
+	smc_uint32_t    lag_max;                      /* max unread messages when reading */
+	smc_uint32_t    lost;                         /* messages overwritten before read */
+} smc_subscriber_t;
+#endif
+
+#ifdef SMC_USING_WAKEUP_LATENCY
+/**
+ * Wakeup-to-run latency of a priority, in cpu cycles
+ */
+typedef struct smc_latency {
+	smc_uint32_t    count;
+	smc_uint32_t    max;
+	smc_uint64_t    sum;
+	smc_uint32_t    hist[SMC_LATENCY_BUCKETS];
+} smc_latency_t;
+#endif
+
+#ifdef SMC_USING_THREADED_IRQ
+/**
+ * Threaded interrupt descriptor, the latency is from the top half to the
+ * handler thread, in cpu cycles.
+ */
+typedef struct smc_irq_desc {
+	void (*ack)(void *arg);                       /* top half, acknowledge the hardware */
+	void (*handler)(void *arg);                   /* run in handler thread */
+	void            *arg;
+	smc_thread_t    thread;                       /* the handler thread */
+	smc_uint32_t    irq;                          /* the interrupt number */
+	smc_uint32_t    stamp;                        /* the cpu cycle of top half */
+	volatile smc_uint8_t pending;
+
+	smc_uint32_t    count;                        /* how many times the handler runs */
+	smc_uint32_t    latency_min;
+	smc_uint32_t    latency_max;
+	smc_uint64_t    latency_sum;
+} smc_irq_desc_t;
+#endif
+
+#ifdef SMC_USING_IRQOFF_PROFILE
+/**
+ * The interrupt disabled time of a critical section call site, in cpu cycles.
+ * The nested sections are counted in the outermost one.
+ */
+typedef struct smc_irqoff_site {
+	const char      *file;                        /* NULL if the slot is free */
+	smc_uint32_t    line;
+	smc_uint32_t    count;                        /* how many times the section runs */
+	smc_uint32_t    max;
+	smc_uint64_t    sum;
+	smc_uint32_t    hist[SMC_IRQOFF_HIST_BUCKETS];
+} smc_irqoff_site_t;
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,73 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-27
+ * Describe: This is a part of SMC-RTOS for C++, the scoped guards of
+ *           critical section and scheduler lock.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_GUARD_HPP
+#define SMC_GUARD_HPP
+
+#include "smc_rtos.h"
+
+namespace smc {
+
+/**
+ * Interrupt is disabled in the scope of guard, and the saved status is
+ * restored on any return path.
+ */
+class CriticalSection {
+public:
+#if defined(SMC_USING_IRQOFF_PROFILE) && !defined(SMC_CPU_PORT)
+	/**
+	 * The profiler records the site declaring the guard, not this header.
+	 */
+	explicit CriticalSection(const char *file = __builtin_FILE(),
+	                         smc_uint32_t line = __builtin_LINE()) noexcept
+		: status_(smc_irqoff_enter(file, line))
+	{
+	}
+#else
+	CriticalSection() noexcept
+		: status_(smc_cpu_disable_interrupt())
+	{
+	}
+#endif
+
+	~CriticalSection() noexcept
+	{
+		smc_cpu_enable_interrupt(status_);
+	}
+
+	CriticalSection(const CriticalSection &) = delete;
+	CriticalSection &operator=(const CriticalSection &) = delete;
+
+private:
+	smc_uint32_t status_;
+};
+
+/**
+ * Scheduler is locked in the scope of guard, interrupt is still enabled.
+ */
+class SchedulerLock {
+public:
+	SchedulerLock() noexcept
+	{
+		smc_scheduler_lock();
+	}
+
+	~SchedulerLock() noexcept
+	{
+		smc_scheduler_unlock();
+	}
+
+	SchedulerLock(const SchedulerLock &) = delete;
+	SchedulerLock &operator=(const SchedulerLock &) = delete;
+};
+
+} // namespace smc
+
+#endif // SMC_GUARD_HPP
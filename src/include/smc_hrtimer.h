@@ -0,0 +1,68 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-06
+ * Describe: This is a part of SMC-RTOS for high-resolution timer
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_HRTIMER_H
+#define SMC_HRTIMER_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_HRTIMER
+
+/**
+ * This function will init a high-resolution timer
+ *
+ * @param timer     [the timer to be initialized]
+ * @param timeout   [the function will be invoked when the timer expires]
+ * @param parameter [the function parameter]
+ */
+void smc_hrtimer_init(smc_hrtimer_t *timer,
+                      void (*timeout)(void *parameter),
+                      void *parameter);
+
+/**
+ * This function will start a one-shot high-resolution timer, if the timer
+ * is active, it will be restarted.
+ *
+ * @param timer [the timer to be started]
+ * @param us    [the microseconds from now]
+ */
+void smc_hrtimer_start(smc_hrtimer_t *timer, smc_uint32_t us);
+
+/**
+ * This function will cancel a high-resolution timer
+ *
+ * @param timer [the timer to be cancelled]
+ */
+void smc_hrtimer_cancel(smc_hrtimer_t *timer);
+
+/**
+ * This function will return the monotonic time since the high-resolution
+ * counter starts.
+ *
+ * @return [the microseconds]
+ */
+smc_uint64_t smc_time_now_us(void);
+
+/**
+ * The function will process the expired high-resolution timers, it should be
+ * invoked by the compare interrupt handle of BSP.
+ */
+void smc_hrtimer_isr(void);
+
+#endif /* SMC_USING_HRTIMER */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_HRTIMER_H
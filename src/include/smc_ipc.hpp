@@ -0,0 +1,341 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-27
+ * Describe: This is a part of SMC-RTOS for C++, the typed wrappers of
+ *           message queue and timer.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_IPC_HPP
+#define SMC_IPC_HPP
+
+#if __cplusplus < 201703L
+#error SMC-RTOS C++ layer needs C++17 or later
+#endif
+
+#include "smc_rtos.h"
+#include "smc_guard.hpp"
+
+namespace smc {
+
+#ifdef SMC_USING_SEMAPHORE
+/**
+ * Fixed size message queue, the items are copied in and out. The free slots
+ * and the queued items are counted by two semaphores.
+ *
+ * @param T [the item type]
+ * @param N [the max number of items]
+ */
+template <typename T, smc_uint16_t N>
+class Queue {
+	static_assert(N > 0, "queue must hold one item at least");
+	static_assert(__is_trivially_copyable(T),
+	              "queue item is copied as plain memory");
+
+public:
+	constexpr Queue() noexcept
+	{
+	}
+
+	Queue(const Queue &) = delete;
+	Queue &operator=(const Queue &) = delete;
+
+	/**
+	 * This function will initialize the queue, it should be invoked before
+	 * any thread uses it.
+	 */
+	void start() noexcept
+	{
+		smc_sem_init(&slots_, N);
+		smc_sem_init(&items_, 0);
+		head_ = 0;
+		tail_ = 0;
+	}
+
+	/**
+	 * This function will send an item to the tail of queue, it can be
+	 * invoked in interrupt handle with SMC_SEM_NO_WAIT.
+	 *
+	 * @param item     [the item]
+	 * @param time_out [the waiting time for a free slot]
+	 *
+	 * @return         [error number]
+	 */
+	smc_int32_t send(const T &item,
+	                 smc_int32_t time_out = SMC_SEM_WAIT_FOREVER) noexcept
+	{
+		smc_int32_t error_num = smc_sem_pend(&slots_, time_out);
+
+		if (error_num != SMC_OK)
+			return error_num;
+
+		{
+			CriticalSection cs;
+
+			buffer_[tail_] = item;
+			tail_          = next(tail_);
+		}
+
+		return smc_sem_release(&items_);
+	}
+
+	/**
+	 * This function will receive an item from the head of queue, it can be
+	 * invoked in interrupt handle with SMC_SEM_NO_WAIT.
+	 *
+	 * @param item     [the received item]
+	 * @param time_out [the waiting time for an item]
+	 *
+	 * @return         [error number]
+	 */
+	smc_int32_t receive(T &item,
+	                    smc_int32_t time_out = SMC_SEM_WAIT_FOREVER) noexcept
+	{
+		smc_int32_t error_num = smc_sem_pend(&items_, time_out);
+
+		if (error_num != SMC_OK)
+			return error_num;
+
+		{
+			CriticalSection cs;
+
+			item  = buffer_[head_];
+			head_ = next(head_);
+		}
+
+		return smc_sem_release(&slots_);
+	}
+
+private:
+	static constexpr smc_uint16_t next(smc_uint16_t index) noexcept
+	{
+		return index + 1U == N ? 0 : index + 1U;
+	}
+
+	smc_sem_t slots_{};
+	smc_sem_t items_{};
+	smc_uint16_t head_ = 0;
+	smc_uint16_t tail_ = 0;
+	T buffer_[N]{};
+};
+#endif /* SMC_USING_SEMAPHORE */
+
+#ifdef SMC_USING_TOPIC
+/**
+ * Typed topic with its history
+ *
+ * @param T     [the message type]
+ * @param Depth [how many messages are kept]
+ */
+template <typename T, smc_uint16_t Depth = 1>
+class Topic {
+	static_assert(Depth > 0 && (Depth & (Depth - 1)) == 0,
+	              "topic depth must be power of 2");
+	static_assert(__is_trivially_copyable(T),
+	              "topic message is copied as plain memory");
+	static_assert(sizeof(T) <= 0xFFFF, "topic message is too large");
+
+public:
+	constexpr Topic() noexcept
+	{
+	}
+
+	Topic(const Topic &) = delete;
+	Topic &operator=(const Topic &) = delete;
+
+	/**
+	 * This function will initialize the topic, it should be invoked before
+	 * any thread uses it.
+	 *
+	 * @param name [the name of topic]
+	 */
+	void start(const char *name = nullptr) noexcept
+	{
+		smc_topic_init(&topic_, name, history_, sizeof(T), Depth);
+	}
+
+	void publish(const T &msg) noexcept
+	{
+		smc_topic_publish(&topic_, &msg);
+	}
+
+	smc_topic_t *native() noexcept
+	{
+		return &topic_;
+	}
+
+private:
+	smc_topic_t topic_{};
+	T history_[Depth]{};
+};
+
+/**
+ * Typed subscriber, it's owned by one reader.
+ *
+ * @param T [the message type]
+ */
+template <typename T>
+class Subscriber {
+public:
+	template <smc_uint16_t Depth>
+	explicit Subscriber(Topic<T, Depth> &topic) noexcept
+	{
+		smc_topic_subscribe(&sub_, topic.native());
+	}
+
+	Subscriber(const Subscriber &) = delete;
+	Subscriber &operator=(const Subscriber &) = delete;
+
+	/**
+	 * This function will read the latest message
+	 *
+	 * @return [how many messages are unread before, -SMC_ERROR if nothing]
+	 * is published.
+	 */
+	smc_int32_t latest(T &msg) noexcept
+	{
+		return smc_topic_read_latest(&sub_, &msg);
+	}
+
+	/**
+	 * This function will read the oldest unread message in history
+	 *
+	 * @return [SMC_OK on success, -SMC_TIMEOUT if there is no unread message]
+	 */
+	smc_int32_t next(T &msg) noexcept
+	{
+		return smc_topic_read_next(&sub_, &msg);
+	}
+
+	smc_int32_t wait(smc_int32_t time_out = SMC_TOPIC_WAIT_FOREVER) noexcept
+	{
+		return smc_topic_wait(&sub_, time_out);
+	}
+
+	smc_subscriber_t *native() noexcept
+	{
+		return &sub_;
+	}
+
+private:
+	smc_subscriber_t sub_;
+};
+#endif /* SMC_USING_TOPIC */
+
+/**
+ * The context type of timer callback, void for a callback without argument
+ */
+template <typename Callback>
+struct timer_context;
+
+template <>
+struct timer_context<void (*)()> {
+	using type = void;
+	static constexpr bool none = true;
+};
+
+template <typename Context>
+struct timer_context<void (*)(Context &)> {
+	using type = Context;
+	static constexpr bool none = false;
+};
+
+/**
+ * Software timer with typed callback. The callback is a template argument,
+ * so the dispatch is inlined into the trampoline passed to the timer list.
+ *
+ * @param Callback [void (*)() or void (*)(Context &)]
+ */
+template <auto Callback>
+class Timer {
+	using context_t = typename timer_context<decltype(Callback)>::type;
+
+public:
+	enum Mode : smc_uint8_t {
+		Once     = SMC_TIMER_ONCE,
+		Periodic = SMC_TIMER_PERIODIC
+	};
+
+	constexpr Timer() noexcept
+	{
+	}
+
+	Timer(const Timer &) = delete;
+	Timer &operator=(const Timer &) = delete;
+
+	/**
+	 * This function will start the timer, a running timer is restarted.
+	 *
+	 * @param tick    [the ticks to expire]
+	 * @param mode    [once or periodic]
+	 * @param context [the argument of callback, unused if no argument]
+	 */
+	void start(smc_uint32_t tick,
+	           Mode mode = Once,
+	           context_t *context = nullptr) noexcept
+	{
+		smc_timer_disable(&timer_);
+		smc_timer_init(&timer_, tick, dispatch, (void *)context, mode);
+#ifdef SMC_USING_TIMER_SLACK
+		timer_.slack      = slack_;
+		timer_.deferrable = deferrable_;
+#endif
+		smc_timer_enable(&timer_);
+	}
+
+	void stop() noexcept
+	{
+		smc_timer_disable(&timer_);
+	}
+
+	/**
+	 * This function will set the period, it works since the next cycle
+	 *
+	 * @param tick [the ticks of period]
+	 */
+	void set_period(smc_uint32_t tick) noexcept
+	{
+		smc_timer_command(&timer_, SMC_TIMER_SET_TIMEOUT_TICK_AFTER, &tick);
+	}
+
+#ifdef SMC_USING_TIMER_SLACK
+	/**
+	 * This function will set the slack and deferrable, they work since the
+	 * next start.
+	 *
+	 * @param slack      [the ticks the expiry can be late]
+	 * @param deferrable [the timer doesn't keep cpu awake]
+	 */
+	void set_slack(smc_uint32_t slack, bool deferrable = false) noexcept
+	{
+		slack_      = slack;
+		deferrable_ = deferrable;
+	}
+#endif
+
+	smc_timer_t *native() noexcept
+	{
+		return &timer_;
+	}
+
+private:
+	static void dispatch(void *parameter)
+	{
+		if constexpr (timer_context<decltype(Callback)>::none)
+			Callback();
+		else
+			Callback(*static_cast<context_t *>(parameter));
+	}
+
+	smc_timer_t timer_{};
+#ifdef SMC_USING_TIMER_SLACK
+	smc_uint32_t slack_     = 0;
+	smc_uint8_t deferrable_ = 0;
+#endif
+};
+
+} // namespace smc
+
+#endif // SMC_IPC_HPP
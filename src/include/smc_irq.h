@@ -0,0 +1,70 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-01
+ * Describe: This is a part of SMC-RTOS for threaded interrupt, the top half
+ *           acknowledges the hardware and a thread handles the interrupt.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_IRQ_H
+#define SMC_IRQ_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_THREADED_IRQ
+
+/**
+ * This function will request a threaded interrupt, the handler thread is
+ * created and the interrupt is unmasked.
+ *
+ * @param desc        [the interrupt descriptor]
+ * @param irq         [the interrupt number]
+ * @param ack         [the top half to acknowledge the hardware, can be NULL]
+ * @param handler     [the function run in handler thread]
+ * @param arg         [the argument of ack and handler]
+ * @param priority    [the priority of handler thread]
+ * @param stack_start [the start address of handler thread stack]
+ * @param stack_size  [the size of handler thread stack]
+ *
+ * @return            [SMC_OK on success, -SMC_BUSY if irq is requested]
+ */
+smc_int32_t smc_irq_request(smc_irq_desc_t *desc,
+                            smc_uint32_t irq,
+                            void (*ack)(void *arg),
+                            void (*handler)(void *arg),
+                            void *arg,
+                            smc_uint8_t priority,
+                            void *stack_start,
+                            smc_uint32_t stack_size);
+
+/**
+ * This function is the top half of threaded interrupt, it should be invoked
+ * by the interrupt vector between smc_enter_interrupt() and
+ * smc_exit_interrupt(). The interrupt is masked until the handler returns.
+ *
+ * @param irq [the interrupt number]
+ *
+ * @return    [SMC_OK on success, -SMC_ERROR if irq isn't requested]
+ */
+smc_int32_t smc_irq_dispatch(smc_uint32_t irq);
+
+/**
+ * This function will reset the latency statistics of threaded interrupt
+ *
+ * @param desc [the interrupt descriptor]
+ */
+void smc_irq_stats_reset(smc_irq_desc_t *desc);
+
+#endif /* SMC_USING_THREADED_IRQ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_IRQ_H
@@ -0,0 +1,61 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-07
+ * Describe: This is a part of SMC-RTOS for interrupt disabled time profiler,
+ *           the critical sections are measured by cpu cycle counter and
+ *           recorded per call site.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_IRQOFF_H
+#define SMC_IRQOFF_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_IRQOFF_PROFILE
+
+/**
+ * This function will reset the nesting and the records, it's invoked by
+ * smc_rtos_scheduler() because interrupt is disabled without pair before
+ * the system starts.
+ */
+void smc_irqoff_start(void);
+
+/**
+ * This function will clear the records of all call sites
+ */
+void smc_irqoff_reset(void);
+
+/**
+ * This function will report the worst call sites ordered by the maximum
+ * interrupt disabled cycles. Each site is copied with interrupt disabled
+ * briefly, so it can be invoked while the system is running.
+ *
+ * @param sites [the array to store the copies of sites]
+ * @param num   [the size of array]
+ *
+ * @return      [how many sites are stored]
+ */
+smc_uint32_t smc_irqoff_report(smc_irqoff_site_t *sites, smc_uint32_t num);
+
+/**
+ * This function will return how many critical sections are not recorded
+ * because the site table is full.
+ *
+ * @return [the dropped count]
+ */
+smc_uint32_t smc_irqoff_dropped(void);
+
+#endif /* SMC_USING_IRQOFF_PROFILE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_IRQOFF_H
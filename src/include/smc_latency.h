@@ -0,0 +1,54 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-09
+ * Describe: This is a part of SMC-RTOS for wakeup-to-run latency, the time
+ *           from a thread becoming ready to its first instruction after the
+ *           context switch is recorded per priority.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_LATENCY_H
+#define SMC_LATENCY_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_WAKEUP_LATENCY
+
+/**
+ * This function will record the latency of the thread switched in, it's
+ * invoked by the port with interrupt disabled after smc_thread_current is
+ * updated.
+ *
+ * @param thread [the thread switched in]
+ */
+void smc_latency_switch_in(smc_thread_t *thread);
+
+/**
+ * This function will get the latency of a priority. The histogram bucket n
+ * counts the cycles in [2^(n-1), 2^n), and the last counts the rest.
+ *
+ * @param priority [the priority]
+ * @param latency  [the copy of latency]
+ *
+ * @return         [SMC_OK on success, -SMC_ERROR if priority is invalid]
+ */
+smc_int32_t smc_latency_get(smc_uint8_t priority, smc_latency_t *latency);
+
+/**
+ * This function will clear the latency of all priorities
+ */
+void smc_latency_reset(void);
+
+#endif /* SMC_USING_WAKEUP_LATENCY */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_LATENCY_H
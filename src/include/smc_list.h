@@ -17,6 +17,8 @@ extern "C" {
 /* Compiler Related Definitions */
 #ifdef __CC_ARM                         /* ARM Compiler */
 	#define smc_inline                   static __inline
+#elif defined(__GNUC__)                 /* GNU GCC Compiler */
+	#define smc_inline                   static __inline
 #else
 	#define smc_inline
 #endif
@@ -44,40 +46,40 @@ smc_inline void smc_list_node_init(struct smc_list_node *list)
  * This is only for internal list manipulation where we know
  * the prev/next entries already!
  */
-smc_inline void __list_add(struct smc_list_node *new,
+smc_inline void __list_add(struct smc_list_node *node,
                            struct smc_list_node *prev,
                            struct smc_list_node *next)
 {
-	next->prev = new;
-	new->next  = next;
-	new->prev  = prev;
-	prev->next = new;
+	next->prev = node;
+	node->next = next;
+	node->prev = prev;
+	prev->next = node;
 }
 
 /**
  * list_add - add a new entry
- * @new: new entry to be added
+ * @node: new entry to be added
  * @head: list head to add it after
  *
  * Insert a new entry after the specified head.
  * This is good for implementing stacks.
  */
-smc_inline void smc_list_add(struct smc_list_node *new, struct smc_list_node *head)
+smc_inline void smc_list_add(struct smc_list_node *node, struct smc_list_node *head)
 {
-	__list_add(new, head, head->next);
+	__list_add(node, head, head->next);
 }
 
 /**
  * list_add_tail - add a new entry
- * @new: new entry to be added
+ * @node: new entry to be added
  * @head: list head to add it before
  *
  * Insert a new entry before the specified head.
  * This is useful for implementing queues.
  */
-smc_inline void smc_list_add_tail(struct smc_list_node *new, struct smc_list_node *head)
+smc_inline void smc_list_add_tail(struct smc_list_node *node, struct smc_list_node *head)
 {
-	__list_add(new, head->prev, head);
+	__list_add(node, head->prev, head);
 }
 
 /*
@@ -0,0 +1,110 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-08
+ * Describe: This is a part of SMC-RTOS for lock contention statistics, the
+ *           locks are enumerated through a registry.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_LOCKSTAT_H
+#define SMC_LOCKSTAT_H
+
+#include "smc_def.h"
+#include "smc_atomic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_LOCK_STATS
+
+/**
+ * This function will initialize the statistics, it's invoked by the init
+ * function of lock. A registered lock should be unregistered before it's
+ * initialized again.
+ *
+ * @param stat [the statistics]
+ */
+void smc_lockstat_init(smc_lockstat_t *stat);
+
+/**
+ * This function will count a pend of lock, it's the only cost of the fast
+ * path.
+ *
+ * @param stat [the statistics]
+ */
+smc_inline void smc_lockstat_pend(smc_lockstat_t *stat)
+{
+	smc_atomic_add(&stat->pends, 1);
+}
+
+/**
+ * This function will count a contended pend, it should be invoked with
+ * interrupt disabled.
+ *
+ * @param stat [the statistics]
+ *
+ * @return     [the cpu cycle when the thread starts waiting]
+ */
+smc_uint32_t smc_lockstat_contend(smc_lockstat_t *stat);
+
+/**
+ * This function will record the blocked time after the thread is waked, it
+ * should be invoked with interrupt enabled.
+ *
+ * @param stat      [the statistics]
+ * @param stamp     [the cycle returned by smc_lockstat_contend()]
+ * @param error_num [the result of waiting]
+ */
+void smc_lockstat_wait_done(smc_lockstat_t *stat,
+                            smc_uint32_t stamp,
+                            smc_int32_t error_num);
+
+/**
+ * This function will add the statistics of a lock to registry, e.g.
+ *
+ *   smc_lockstat_register(&sem.stats, "uart tx");
+ *
+ * @param stat [the statistics]
+ * @param name [the name of lock]
+ *
+ * @return     [SMC_OK on success, -SMC_BUSY if it's registered]
+ */
+smc_int32_t smc_lockstat_register(smc_lockstat_t *stat, const char *name);
+
+/**
+ * This function will remove the statistics of a lock from registry
+ *
+ * @param stat [the statistics]
+ */
+void smc_lockstat_unregister(smc_lockstat_t *stat);
+
+/**
+ * This function will clear the statistics, the registry is kept.
+ *
+ * @param stat [the statistics]
+ */
+void smc_lockstat_reset(smc_lockstat_t *stat);
+
+/**
+ * This function will report the registered locks ordered by the total
+ * blocked time. Each lock is copied with interrupt disabled briefly, so it
+ * can be invoked while the system is running. The walk starts again if a
+ * lock is unregistered meanwhile.
+ *
+ * @param stats [the array to store the copies of statistics]
+ * @param num   [the size of array]
+ *
+ * @return      [how many locks are stored]
+ */
+smc_uint32_t smc_lockstat_report(smc_lockstat_t *stats, smc_uint32_t num);
+
+#endif /* SMC_USING_LOCK_STATS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_LOCKSTAT_H
@@ -0,0 +1,192 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-11
+ * Describe: This is a part of SMC-RTOS for packet buffer, the fixed size
+ *           buffers are allocated from pools, chained for large payload and
+ *           shared by reference count.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_PBUF_H
+#define SMC_PBUF_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_PBUF
+
+#ifndef SMC_USING_SEMAPHORE
+#error packet buffer needs SMC_USING_SEMAPHORE
+#endif
+
+/**
+ * Special waiting time for packet buffer
+ */
+#define SMC_PBUF_WAIT_FOREVER           -1
+#define SMC_PBUF_NO_WAIT                 0
+
+/**
+ * The memory size of a pool, e.g.
+ *
+ *   static smc_uint32_t memory[SMC_PBUF_POOL_SIZE(16, 128) / 4];
+ *
+ * @param num  [how many buffers]
+ * @param size [data bytes of a buffer]
+ */
+#define SMC_PBUF_POOL_SIZE(num, size)   ((num) * SMC_ALIGN(sizeof(smc_pbuf_t) + (size), 4))
+
+/**
+ * This function will initialize a pool
+ *
+ * @param pool     [the pool]
+ * @param memory   [the memory of buffers, 4-bytes aligned]
+ * @param size     [the size of memory]
+ * @param buf_size [data bytes of a buffer]
+ *
+ * @return         [SMC_OK on success, -SMC_NOMEM if memory holds no buffer]
+ */
+smc_int32_t smc_pbuf_pool_init(smc_pbuf_pool_t *pool,
+                               void *memory,
+                               smc_uint32_t size,
+                               smc_uint16_t buf_size);
+
+/**
+ * This function will allocate a chain holding len bytes, the first buffer
+ * reserves headroom for the headers prepended later. The reference count is
+ * one. The caller waits until the pool has all the buffers of chain. It can
+ * be invoked in interrupt handle with SMC_PBUF_NO_WAIT.
+ *
+ * @param pool     [the pool]
+ * @param len      [the data length]
+ * @param headroom [the bytes reserved before data, less than buffer size]
+ * @param time_out [the waiting time for free buffers]
+ *
+ * @return         [the chain, NULL on timeout or invalid argument]
+ */
+smc_pbuf_t *smc_pbuf_alloc(smc_pbuf_pool_t *pool,
+                           smc_uint16_t len,
+                           smc_uint16_t headroom,
+                           smc_int32_t time_out);
+
+/**
+ * This function will add a reference to chain, so one more consumer can
+ * hold it. It can be invoked in interrupt handle.
+ *
+ * @param p [the chain]
+ */
+void smc_pbuf_ref(smc_pbuf_t *p);
+
+/**
+ * This function will drop a reference of chain. The buffers whose reference
+ * count reaches zero are returned to their pools. It can be invoked in
+ * interrupt handle.
+ *
+ * @param p [the chain]
+ *
+ * @return  [how many buffers are freed]
+ */
+smc_uint32_t smc_pbuf_free(smc_pbuf_t *p);
+
+/**
+ * This function will move the payload of the first buffer, a positive
+ * delta prepends a header in headroom and a negative one hides a header.
+ * A shared buffer should not be changed.
+ *
+ * @param p     [the chain]
+ * @param delta [the bytes to move]
+ *
+ * @return      [SMC_OK on success, -SMC_ERROR if out of buffer]
+ */
+smc_int32_t smc_pbuf_header(smc_pbuf_t *p, smc_int16_t delta);
+
+/**
+ * This function will append a chain to another, the reference of tail is
+ * taken over by head.
+ *
+ * @param head [the chain]
+ * @param tail [the chain appended]
+ *
+ * @return     [SMC_OK on success, -SMC_ERROR if the length overflows]
+ */
+smc_int32_t smc_pbuf_cat(smc_pbuf_t *head, smc_pbuf_t *tail);
+
+/**
+ * This function will copy bytes into chain
+ *
+ * @param p      [the chain]
+ * @param data   [the bytes]
+ * @param len    [the number of bytes]
+ * @param offset [the offset in chain]
+ *
+ * @return       [how many bytes are copied]
+ */
+smc_uint32_t smc_pbuf_copy_in(smc_pbuf_t *p,
+                              const void *data,
+                              smc_uint32_t len,
+                              smc_uint32_t offset);
+
+/**
+ * This function will copy bytes out of chain
+ *
+ * @param p      [the chain]
+ * @param data   [the buffer of bytes]
+ * @param len    [the size of buffer]
+ * @param offset [the offset in chain]
+ *
+ * @return       [how many bytes are copied]
+ */
+smc_uint32_t smc_pbuf_copy_out(smc_pbuf_t *p,
+                               void *data,
+                               smc_uint32_t len,
+                               smc_uint32_t offset);
+
+/**
+ * This function will initialize a queue passing chains between threads
+ *
+ * @param queue [the queue]
+ * @param slot  [the array of slots]
+ * @param size  [how many slots]
+ */
+void smc_pbuf_queue_init(smc_pbuf_queue_t *queue,
+                         smc_pbuf_t **slot,
+                         smc_uint16_t size);
+
+/**
+ * This function will post a chain to queue, the reference of caller is
+ * passed to the receiver. Post to several queues after smc_pbuf_ref() to
+ * share a chain. It can be invoked in interrupt handle with
+ * SMC_PBUF_NO_WAIT.
+ *
+ * @param queue    [the queue]
+ * @param p        [the chain]
+ * @param time_out [the waiting time for a free slot]
+ *
+ * @return         [error number]
+ */
+smc_int32_t smc_pbuf_queue_post(smc_pbuf_queue_t *queue,
+                                smc_pbuf_t *p,
+                                smc_int32_t time_out);
+
+/**
+ * This function will fetch a chain from queue, the receiver owns a
+ * reference and frees it when done.
+ *
+ * @param queue    [the queue]
+ * @param time_out [the waiting time for a chain]
+ *
+ * @return         [the chain, NULL on timeout]
+ */
+smc_pbuf_t *smc_pbuf_queue_fetch(smc_pbuf_queue_t *queue, smc_int32_t time_out);
+
+#endif /* SMC_USING_PBUF */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_PBUF_H
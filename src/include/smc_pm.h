@@ -0,0 +1,90 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-31
+ * Describe: This is a part of SMC-RTOS for idle power governor, it chooses
+ *           the idle state by the predicted idle time and latency constraint.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_PM_H
+#define SMC_PM_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_PM
+
+#ifdef SMC_USING_CPU_USAGE
+#error cpu usage counts idle loops, it conflicts with SMC_USING_PM
+#endif
+
+/**
+ * the index of built-in idle states
+ */
+#define SMC_PM_STATE_SPIN               0
+#define SMC_PM_STATE_WFI                1
+
+/**
+ * This function will register a deep idle state, the states should be
+ * registered from shallow to deep.
+ *
+ * @param state [the idle state]
+ *
+ * @return      [the index of state, -SMC_NOMEM if it's full]
+ *
+ * @note        [if the state stops the tick, the enter function should]
+ * wake up after sleep_us at most and return the slept microseconds until it
+ * returns. The time beyond sleep_us is the wake latency of the state.
+ */
+smc_int32_t smc_pm_state_register(smc_pm_state_t *state);
+
+/**
+ * This function will return an idle state for its statistics
+ *
+ * @param index [the index of state]
+ *
+ * @return      [the idle state, NULL if it doesn't exist]
+ */
+smc_pm_state_t *smc_pm_state_get(smc_uint8_t index);
+
+/**
+ * This function will add a wakeup latency constraint
+ *
+ * @param qos        [the constraint]
+ * @param latency_us [the max tolerable wakeup latency]
+ */
+void smc_pm_qos_add(smc_pm_qos_t *qos, smc_uint32_t latency_us);
+
+/**
+ * This function will update a wakeup latency constraint
+ *
+ * @param qos        [the constraint]
+ * @param latency_us [the max tolerable wakeup latency]
+ */
+void smc_pm_qos_update(smc_pm_qos_t *qos, smc_uint32_t latency_us);
+
+/**
+ * This function will remove a wakeup latency constraint
+ *
+ * @param qos [the constraint]
+ */
+void smc_pm_qos_remove(smc_pm_qos_t *qos);
+
+/**
+ * This function will choose an idle state and enter it, it's invoked by
+ * idle thread loop.
+ */
+void smc_pm_idle(void);
+
+#endif /* SMC_USING_PM */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_PM_H
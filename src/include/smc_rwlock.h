@@ -0,0 +1,78 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-17
+ * Describe: This is a part of SMC-RTOS for reader-writer lock
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_RWLOCK_H
+#define SMC_RWLOCK_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_RWLOCK
+
+/**
+ * reader-writer lock wait mode
+ */
+#define SMC_RWLOCK_WAIT_FOREVER         -1
+#define SMC_RWLOCK_NO_WAIT               0
+
+/**
+ * This function will initialize a reader-writer lock
+ *
+ * @param lock [the reader-writer lock]
+ */
+void smc_rwlock_init(smc_rwlock_t *lock);
+
+/**
+ * This function will take the lock for reading. Many readers can hold the
+ * lock at the same time, but a reader will wait if a writer holds or waits
+ * for the lock.
+ *
+ * @param lock     [the reader-writer lock]
+ * @param time_out [the waiting time]
+ *
+ * @return         [error number]
+ */
+smc_int32_t smc_rwlock_read_lock(smc_rwlock_t *lock, smc_int32_t time_out);
+
+/**
+ * This function will take the lock for writing exclusively. The writer
+ * holding the lock inherits the priority of the threads waiting for it.
+ *
+ * @param lock     [the reader-writer lock]
+ * @param time_out [the waiting time]
+ *
+ * @return         [error number]
+ *
+ * @note [the inheritance is one level only, if the boosted writer waits]
+ * for another lock or semaphore, it keeps its place in that wait queue and
+ * the holder there isn't boosted.
+ */
+smc_int32_t smc_rwlock_write_lock(smc_rwlock_t *lock, smc_int32_t time_out);
+
+/**
+ * This function will release the lock held by the current thread for reading
+ * or writing. The waiting writer is waked first, otherwise all the waiting
+ * readers are waked.
+ *
+ * @param lock [the reader-writer lock]
+ *
+ * @return     [error number]
+ */
+smc_int32_t smc_rwlock_unlock(smc_rwlock_t *lock);
+
+#endif /* SMC_USING_RWLOCK */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_RWLOCK_H
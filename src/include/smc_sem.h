@@ -25,13 +25,23 @@ extern "C" {
 #define SMC_SEM_NO_WAIT                  0
 
 /**
- * This function will initialize a semaphore
+ * This function will initialize a semaphore, the suspended threads are
+ * waked in priority order.
  *
  * @param sem   [the semaphore]
  * @param value [the init value of semaphore]
  */
 void smc_sem_init(smc_sem_t *sem, smc_uint16_t value);
 
+/**
+ * This function will initialize a semaphore with a wait queue policy
+ *
+ * @param sem    [the semaphore]
+ * @param value  [the init value of semaphore]
+ * @param policy [the wait queue policy of the suspended threads]
+ */
+void smc_sem_init_policy(smc_sem_t *sem, smc_uint16_t value, smc_uint8_t policy);
+
 /**
  * This function will wait a semaphore, if the semaphore is unavailable, the
  * thread shall wait for a specified time.
@@ -43,6 +53,17 @@ void smc_sem_init(smc_sem_t *sem, smc_uint16_t value);
  */
 smc_int32_t smc_sem_pend(smc_sem_t *sem, smc_int32_t time_out);
 
+/**
+ * This function will take a semaphore if it's available without waiting.
+ * It's the probe of wait set and coroutine, so it isn't counted by lock
+ * statistics. It can be invoked in interrupt handle.
+ *
+ * @param sem [the semaphore]
+ *
+ * @return    [SMC_OK on success, -SMC_TIMEOUT if it's unavailable]
+ */
+smc_int32_t smc_sem_try_take(smc_sem_t *sem);
+
 /**
  * This function will release a semaphore, if there are threads suspended on
  * semaphore, it will be waked up.
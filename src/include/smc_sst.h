@@ -0,0 +1,78 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-29
+ * Describe: This is a part of SMC-RTOS for run-to-completion task, tasks
+ *           share the main stack and preempt each other by nested call.
+ *           Each task priority has its own software interrupt, so a task
+ *           only runs above the tasks and threads of lower priority.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_SST_H
+#define SMC_SST_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_SST
+
+#if SMC_SST_PRIORITY_MAX > 32
+#error SMC_SST_PRIORITY_MAX must be no more than 32
+#endif
+
+/**
+ * This function will initialize a run-to-completion task. The task runs
+ * above all threads, and its handler must never block.
+ *
+ * @param task     [the task]
+ * @param handler  [the function will be invoked for each event]
+ * @param priority [the unique priority of task, 0 is the highest]
+ * @param queue    [the event queue buffer]
+ * @param size     [the event queue size]
+ *
+ * @return         [SMC_OK on success, -SMC_BUSY if the priority is used]
+ */
+smc_int32_t smc_sst_task_init(smc_sst_task_t *task,
+                              void (*handler)(smc_sst_task_t *task, void *event),
+                              smc_uint8_t priority,
+                              void **queue,
+                              smc_uint8_t size);
+
+/**
+ * This function will post an event to a task. It can be invoked in thread,
+ * task and interrupt handle. The software interrupt of task is pended, so
+ * the task preempts the caller at once if it has higher priority, otherwise
+ * it runs when the caller returns.
+ *
+ * @param task  [the task]
+ * @param event [the event]
+ *
+ * @return      [SMC_OK on success, -SMC_NOMEM if the queue is full]
+ */
+smc_int32_t smc_sst_post(smc_sst_task_t *task, void *event);
+
+/**
+ * This function should be invoked by the software interrupt handler of a
+ * task priority, which is pended by smc_hw_sst_trigger(). It dispatches
+ * all the queued events of the task, the higher tasks and interrupts can
+ * preempt it.
+ *
+ * @param priority [the task priority of the software interrupt]
+ *
+ * @note [the handler should be wrapped by smc_enter_interrupt() and]
+ * smc_exit_interrupt() as other interrupts.
+ */
+void smc_sst_isr(smc_uint8_t priority);
+
+#endif /* SMC_USING_SST */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_SST_H
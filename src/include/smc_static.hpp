@@ -0,0 +1,163 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-26
+ * Describe: This is a part of SMC-RTOS for C++, the kernel objects are
+ *           defined statically by templates and checked at compile time.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_STATIC_HPP
+#define SMC_STATIC_HPP
+
+#if __cplusplus < 201703L
+#error SMC-RTOS C++ layer needs C++17 or later
+#endif
+
+#include "smc_rtos.h"
+#include "smc_idle.h"
+
+namespace smc {
+
+/**
+ * The stack alignment required by the procedure call standard of the port
+ */
+#if defined(__riscv)
+constexpr smc_uint32_t stack_align = 16;
+#else
+constexpr smc_uint32_t stack_align = 8;
+#endif
+
+/**
+ * The smallest stack, it must hold the initial frame built by the port
+ */
+constexpr smc_uint32_t stack_min = 32 * sizeof(smc_stack_t);
+
+/**
+ * Static thread with its aligned stack. The object is constant initialized,
+ * so it costs no static constructor and the stack is in .bss.
+ *
+ * The ready queue entry is made by start(), because smc_rtos_init() resets
+ * the ready queues and the initial frame is built by the port.
+ *
+ * @param StackBytes [the size of thread stack]
+ * @param Priority   [the priority of thread]
+ * @param Entry      [the entry function of thread]
+ * @param SliceTick  [the time slice if there are same priority thread]
+ */
+template <smc_uint32_t StackBytes,
+          smc_uint8_t Priority,
+          void (*Entry)(void *parameter),
+          smc_uint32_t SliceTick = 20>
+class Thread {
+	static_assert(StackBytes >= stack_min,
+	              "thread stack is too small for the initial frame");
+	static_assert(StackBytes % stack_align == 0,
+	              "thread stack size must be a multiple of stack alignment");
+	static_assert(Priority < IDLE_THREAD_PRIORITY,
+	              "thread priority must be higher than idle thread");
+	static_assert(Entry != nullptr, "thread entry must not be null");
+	static_assert(SliceTick > 0, "time slice must be one tick at least");
+
+public:
+	static constexpr smc_uint8_t priority    = Priority;
+	static constexpr smc_uint32_t stack_size = StackBytes;
+
+	constexpr explicit Thread(void *parameter = nullptr) noexcept
+		: parameter_(parameter)
+	{
+	}
+
+	Thread(const Thread &) = delete;
+	Thread &operator=(const Thread &) = delete;
+
+	/**
+	 * This function will build the initial frame and put the thread to
+	 * ready queue, it should be invoked after smc_rtos_init().
+	 */
+	void start() noexcept
+	{
+		smc_thread_init(&thread_,
+		                Entry,
+		                parameter_,
+		                Priority,
+		                stack_,
+		                StackBytes,
+		                SliceTick);
+	}
+
+	smc_thread_t *native() noexcept
+	{
+		return &thread_;
+	}
+
+private:
+	smc_thread_t thread_{};
+	void *parameter_;
+	alignas(stack_align) smc_uint8_t stack_[StackBytes]{};
+};
+
+#ifdef SMC_USING_SEMAPHORE
+/**
+ * Static semaphore
+ *
+ * @param Initial [the init value of semaphore]
+ * @param Policy  [the wait queue policy of the suspended threads]
+ */
+template <smc_uint16_t Initial = 0, smc_uint8_t Policy = SMC_WAITQ_PRIO>
+class Semaphore {
+	static_assert(Policy <= SMC_WAITQ_LIFO, "unknown wait queue policy");
+
+public:
+	constexpr Semaphore() noexcept
+	{
+	}
+
+	Semaphore(const Semaphore &) = delete;
+	Semaphore &operator=(const Semaphore &) = delete;
+
+	/**
+	 * This function will initialize the semaphore, it should be invoked
+	 * before any thread uses it.
+	 */
+	void start() noexcept
+	{
+		smc_sem_init_policy(&sem_, Initial, Policy);
+	}
+
+	smc_int32_t pend(smc_int32_t time_out = SMC_SEM_WAIT_FOREVER) noexcept
+	{
+		return smc_sem_pend(&sem_, time_out);
+	}
+
+	smc_int32_t release() noexcept
+	{
+		return smc_sem_release(&sem_);
+	}
+
+	smc_sem_t *native() noexcept
+	{
+		return &sem_;
+	}
+
+private:
+	smc_sem_t sem_{};
+};
+#endif /* SMC_USING_SEMAPHORE */
+
+/**
+ * This function will start all the static kernel objects in order, normally
+ * it's invoked in smc_app_init().
+ *
+ * @param objects [the static kernel objects]
+ */
+template <typename... Objects>
+inline void start(Objects &...objects) noexcept
+{
+	(objects.start(), ...);
+}
+
+} // namespace smc
+
+#endif // SMC_STATIC_HPP
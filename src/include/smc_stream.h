@@ -0,0 +1,153 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-10
+ * Describe: This is a part of SMC-RTOS for byte stream, one writer and one
+ *           reader share a ring, and the reader is waked when the trigger
+ *           level is reached.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_STREAM_H
+#define SMC_STREAM_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_STREAM
+
+/**
+ * Special waiting time for stream
+ */
+#define SMC_STREAM_WAIT_FOREVER         -1
+#define SMC_STREAM_NO_WAIT               0
+
+/**
+ * This function will initialize a stream
+ *
+ * @param stream  [the stream]
+ * @param buffer  [the ring buffer]
+ * @param size    [the size of buffer, it must be power of 2]
+ * @param trigger [how many bytes wake the reader, in [1, size]]
+ *
+ * @return        [SMC_OK on success, -SMC_ERROR if size or trigger is invalid]
+ */
+smc_int32_t smc_stream_init(smc_stream_t *stream,
+                            void *buffer,
+                            smc_uint32_t size,
+                            smc_uint32_t trigger);
+
+/**
+ * This function will set the trigger level, it works since the next receive.
+ *
+ * @param stream  [the stream]
+ * @param trigger [how many bytes wake the reader, in [1, size]]
+ *
+ * @return        [SMC_OK on success, -SMC_ERROR if trigger is invalid]
+ */
+smc_int32_t smc_stream_set_trigger(smc_stream_t *stream, smc_uint32_t trigger);
+
+/**
+ * This function will copy bytes into stream. It can be invoked in interrupt
+ * handle with SMC_STREAM_NO_WAIT.
+ *
+ * @param stream   [the stream]
+ * @param data     [the bytes]
+ * @param len      [the number of bytes]
+ * @param time_out [the waiting time for free space]
+ *
+ * @return         [how many bytes are copied, less than len on timeout]
+ */
+smc_uint32_t smc_stream_send(smc_stream_t *stream,
+                             const void *data,
+                             smc_uint32_t len,
+                             smc_int32_t time_out);
+
+/**
+ * This function will copy bytes out of stream. The reader waits until the
+ * trigger level (or len if it's smaller) is reached, and then copies all
+ * the available bytes up to len. It can be invoked in interrupt handle with
+ * SMC_STREAM_NO_WAIT.
+ *
+ * @param stream   [the stream]
+ * @param data     [the buffer of bytes]
+ * @param len      [the size of buffer]
+ * @param time_out [the waiting time for trigger level]
+ *
+ * @return         [how many bytes are copied, it may be less than trigger]
+ * level on timeout.
+ */
+smc_uint32_t smc_stream_receive(smc_stream_t *stream,
+                                void *data,
+                                smc_uint32_t len,
+                                smc_int32_t time_out);
+
+/**
+ * This function will get the contiguous free region for writer, the bytes
+ * are filled in place and published by smc_stream_write_commit().
+ *
+ * @param stream [the stream]
+ * @param region [the start of region]
+ *
+ * @return       [the size of region, 0 if stream is full]
+ */
+smc_uint32_t smc_stream_write_peek(smc_stream_t *stream, void **region);
+
+/**
+ * This function will publish the bytes filled in the region of peek, and
+ * wake the reader if the trigger level is reached.
+ *
+ * @param stream [the stream]
+ * @param len    [how many bytes are filled]
+ *
+ * @return       [SMC_OK on success, -SMC_ERROR if len exceeds free space]
+ */
+smc_int32_t smc_stream_write_commit(smc_stream_t *stream, smc_uint32_t len);
+
+/**
+ * This function will get the contiguous available region for reader, the
+ * bytes are consumed in place and released by smc_stream_read_commit().
+ *
+ * @param stream [the stream]
+ * @param region [the start of region]
+ *
+ * @return       [the size of region, 0 if stream is empty]
+ */
+smc_uint32_t smc_stream_read_peek(smc_stream_t *stream, const void **region);
+
+/**
+ * This function will release the bytes consumed in the region of peek, and
+ * wake the writer if there is enough free space.
+ *
+ * @param stream [the stream]
+ * @param len    [how many bytes are consumed]
+ *
+ * @return       [SMC_OK on success, -SMC_ERROR if len exceeds available bytes]
+ */
+smc_int32_t smc_stream_read_commit(smc_stream_t *stream, smc_uint32_t len);
+
+/**
+ * This function will return how many bytes are available to read
+ *
+ * @param stream [the stream]
+ */
+smc_uint32_t smc_stream_available(smc_stream_t *stream);
+
+/**
+ * This function will return how many bytes are free to write
+ *
+ * @param stream [the stream]
+ */
+smc_uint32_t smc_stream_space(smc_stream_t *stream);
+
+#endif /* SMC_USING_STREAM */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_STREAM_H
@@ -64,6 +64,17 @@ void smc_thread_abandon(void);
  */
 void smc_scheduler(void);
 
+/**
+ * This function will suspend the current thread, the thread timer will resume
+ * it with -SMC_TIMEOUT error number if time out.
+ *
+ * @param time_out [the waiting ticks, negative for waiting forever]
+ *
+ * @note           [it must be invoked with interrupt disabled, and then]
+ * smc_scheduler() must be invoked.
+ */
+void smc_thread_suspend_timeout(smc_int32_t time_out);
+
 /**
  * This function will let current thread delay for some ticks.
  *
@@ -71,6 +82,47 @@ void smc_scheduler(void);
  */
 void smc_thread_delay(smc_uint32_t delay_tick);
 
+/**
+ * This function will let current thread delay for some microseconds. The
+ * whole ticks are slept and only the remainder is spun on the cpu cycle
+ * counter, a delay shorter than one tick is spun all.
+ *
+ * @param us [the delay microseconds]
+ *
+ * @note     [in interrupt or with scheduler locked, it spins for all.]
+ */
+void smc_thread_delay_us(smc_uint32_t us);
+
+/**
+ * This function will let current thread delay until an absolute release time,
+ * so the period doesn't drift with the execution time. The last_wake should
+ * be initialized by smc_tick_get() before the periodic loop.
+ *
+ * @param last_wake [the last release tick, it's updated to the next one]
+ * @param period    [the period ticks]
+ *
+ * @return          [SMC_OK, -SMC_TIMEOUT if the release time has passed]
+ */
+smc_int32_t smc_thread_delay_until(smc_uint32_t *last_wake, smc_uint32_t period);
+
+#ifdef SMC_USING_THREAD_STATS
+/**
+ * This function will set the relative deadline of a periodic thread
+ *
+ * @param thread   [the thread]
+ * @param deadline [the deadline ticks after release, 0 for the period]
+ */
+void smc_thread_set_deadline(smc_thread_t *thread, smc_uint32_t deadline);
+
+/**
+ * This function will reset the timing statistics of a thread, and the
+ * deadline is kept.
+ *
+ * @param thread [the thread]
+ */
+void smc_thread_stats_reset(smc_thread_t *thread);
+#endif
+
 /**
  * This function will lock the thread scheduler.
  */
@@ -100,6 +152,19 @@ smc_thread_t *smc_thread_highest_ready(void);
  */
 smc_int32_t smc_thread_suspend(smc_thread_t *thread);
 
+/**
+ * This function will wake a thread up and put it to system ready queue
+ * without schedule.
+ *
+ * @param thread [the thread to be waked up]
+ *
+ * @return       [the operation status, SMC_OK on OK, -SMC_ERROR on error]
+ *
+ * @note         [after this function call, the smc_scheduler() must be]
+ * invoked.
+ */
+smc_int32_t smc_thread_wakeup(smc_thread_t *thread);
+
 /**
  * This function will resume a thread and put it to system ready queue.
  *
@@ -109,6 +174,17 @@ smc_int32_t smc_thread_suspend(smc_thread_t *thread);
  */
 smc_int32_t smc_thread_resume(smc_thread_t *thread);
 
+/**
+ * This function will change the priority of a thread. If the thread is
+ * ready, it will be moved to the ready queue of new priority.
+ *
+ * @param thread   [the thread]
+ * @param priority [the new priority]
+ *
+ * @note           [a suspended thread keeps its position in wait queue]
+ */
+void smc_thread_set_priority(smc_thread_t *thread, smc_uint8_t priority);
+
 /**
  * @ingroup Hook
  * This function sets a hook function to idle thread loop. When the system performs
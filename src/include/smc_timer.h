@@ -16,6 +16,11 @@
 extern "C" {
 #endif
 
+/**
+ * There is no timer will expire
+ */
+#define SMC_TIMER_NO_TIMEOUT            0xFFFFFFFFU
+
 /**
  * This function will init a timer
  *
@@ -51,6 +56,11 @@ void smc_timer_disable(smc_timer_t *timer_del);
  * @param timer [the timer to be set]
  * @param cmd   [the command]
  * @param arg   [the argument]
+ *
+ * @note        [SMC_TIMER_SET_SLACK and SMC_TIMER_SET_DEFERRABLE work since]
+ * the next enable, they need SMC_USING_TIMER_SLACK. The slack delays one
+ * expiry only, a periodic timer keeps its period. A deferrable timer only
+ * differs with SMC_USING_PM, the idle governor ignores it.
  */
 void smc_timer_command(smc_timer_t *timer, smc_uint8_t cmd, void *arg);
 
@@ -60,6 +70,23 @@ void smc_timer_command(smc_timer_t *timer, smc_uint8_t cmd, void *arg);
  */
 void smc_timer_decrease(void);
 
+/**
+ * The function will return the ticks to the next expiry that should wake up
+ * cpu, the deferrable timers are ignored. It's used by tickless idle to
+ * decide how long to sleep.
+ *
+ * @return [the ticks to the next expiry, SMC_TIMER_NO_TIMEOUT if no timer]
+ */
+smc_uint32_t smc_timer_next_timeout(void);
+
+/**
+ * The function will return how many ticks have processed expired timers, it
+ * can be sampled to compute the timer wakeups per second.
+ *
+ * @return [the timer wakeup count]
+ */
+smc_uint32_t smc_timer_wakeup_count(void);
+
 #ifdef __cplusplus
 }
 #endif
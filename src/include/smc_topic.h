@@ -0,0 +1,115 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-12
+ * Describe: This is a part of SMC-RTOS for publish/subscribe topic, the
+ *           latest message is read without lock and a small history is kept
+ *           for the subscribers reading in order.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_TOPIC_H
+#define SMC_TOPIC_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_TOPIC
+
+/**
+ * Special waiting time for topic
+ */
+#define SMC_TOPIC_WAIT_FOREVER          -1
+#define SMC_TOPIC_NO_WAIT                0
+
+/**
+ * This function will initialize a topic
+ *
+ * @param topic   [the topic]
+ * @param name    [the name of topic]
+ * @param history [the memory of depth messages]
+ * @param size    [the message size]
+ * @param depth   [how many messages are kept, it must be power of 2]
+ *
+ * @return        [SMC_OK on success, -SMC_ERROR if depth is invalid]
+ */
+smc_int32_t smc_topic_init(smc_topic_t *topic,
+                           const char *name,
+                           void *history,
+                           smc_uint16_t size,
+                           smc_uint16_t depth);
+
+/**
+ * This function will publish a message and wake all the waiting
+ * subscribers. The message is copied with interrupt disabled, so the
+ * publishers are serialized and the message should be small. It can be
+ * invoked in interrupt handle.
+ *
+ * @param topic [the topic]
+ * @param msg   [the message]
+ */
+void smc_topic_publish(smc_topic_t *topic, const void *msg);
+
+/**
+ * This function will return the publish rate of the last second
+ *
+ * @param topic [the topic]
+ *
+ * @return      [messages per second]
+ */
+smc_uint32_t smc_topic_rate(smc_topic_t *topic);
+
+/**
+ * This function will subscribe a topic, only the messages published since
+ * now are unread.
+ *
+ * @param sub   [the subscriber]
+ * @param topic [the topic]
+ */
+void smc_topic_subscribe(smc_subscriber_t *sub, smc_topic_t *topic);
+
+/**
+ * This function will read the latest message without lock, the read is
+ * retried if the message is overwritten while copying. All the unread
+ * messages are consumed.
+ *
+ * @param sub [the subscriber]
+ * @param msg [the buffer of message]
+ *
+ * @return    [how many messages are unread before, -SMC_ERROR if nothing]
+ * is published.
+ */
+smc_int32_t smc_topic_read_latest(smc_subscriber_t *sub, void *msg);
+
+/**
+ * This function will read the oldest unread message in history without
+ * lock. The messages overwritten before read are counted as lost.
+ *
+ * @param sub [the subscriber]
+ * @param msg [the buffer of message]
+ *
+ * @return    [SMC_OK on success, -SMC_TIMEOUT if there is no unread message]
+ */
+smc_int32_t smc_topic_read_next(smc_subscriber_t *sub, void *msg);
+
+/**
+ * This function will wait until there is an unread message
+ *
+ * @param sub      [the subscriber]
+ * @param time_out [the waiting time]
+ *
+ * @return         [error number]
+ */
+smc_int32_t smc_topic_wait(smc_subscriber_t *sub, smc_int32_t time_out);
+
+#endif /* SMC_USING_TOPIC */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_TOPIC_H
@@ -0,0 +1,72 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-10
+ * Describe: This is a part of SMC-RTOS for wait queue
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_WAITQ_H
+#define SMC_WAITQ_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * wait queue wait mode
+ */
+#define SMC_WAITQ_WAIT_FOREVER          -1
+
+/**
+ * This function will initialize a wait queue
+ *
+ * @param waitq  [the wait queue]
+ * @param policy [the wait queue policy, SMC_WAITQ_PRIO, SMC_WAITQ_FIFO or]
+ * SMC_WAITQ_LIFO
+ */
+void smc_waitq_init(smc_waitq_t *waitq, smc_uint8_t policy);
+
+/**
+ * This function will put a suspended thread to wait queue. With the PRIO
+ * policy the thread is put behind the waiting threads of the same or higher
+ * priority, so the cost grows with the number of waiting threads.
+ *
+ * @param waitq  [the wait queue]
+ * @param thread [the suspended thread]
+ *
+ * @note         [it must be invoked with interrupt disabled]
+ */
+void smc_waitq_add(smc_waitq_t *waitq, smc_thread_t *thread);
+
+/**
+ * This function will suspend the current thread to wait queue, the thread
+ * will be resumed with -SMC_TIMEOUT error number if time out.
+ *
+ * @param waitq    [the wait queue]
+ * @param time_out [the waiting ticks or SMC_WAITQ_WAIT_FOREVER]
+ *
+ * @note           [it must be invoked with interrupt disabled, and then]
+ * smc_scheduler() must be invoked.
+ */
+void smc_waitq_suspend(smc_waitq_t *waitq, smc_int32_t time_out);
+
+/**
+ * This function will return the thread which should be waked first.
+ *
+ * @param waitq [the wait queue]
+ *
+ * @return      [the first thread, NULL if wait queue is empty]
+ *
+ * @note        [it must be invoked with interrupt disabled]
+ */
+smc_thread_t *smc_waitq_first(smc_waitq_t *waitq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_WAITQ_H
@@ -0,0 +1,92 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-24
+ * Describe: This is a part of SMC-RTOS for wait set, a thread can wait for
+ *           several kernel objects at once.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_WAITSET_H
+#define SMC_WAITSET_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_WAITSET
+
+/**
+ * wait set wait mode
+ */
+#define SMC_WAITSET_WAIT_FOREVER        -1
+#define SMC_WAITSET_NO_WAIT              0
+
+/**
+ * This function will initialize an empty wait set, it's cheap enough to be
+ * invoked before each wait.
+ *
+ * @param set [the wait set]
+ */
+void smc_waitset_init(smc_waitset_t *set);
+
+/**
+ * This function will add a kernel object to wait set. The object should
+ * notify its poll list by smc_poll_notify() when it becomes available.
+ *
+ * @param set    [the wait set]
+ * @param object [the kernel object]
+ * @param head   [the poll list of object]
+ * @param take   [the function to take the object without wait]
+ *
+ * @return       [the index of object in wait set, -SMC_NOMEM if it's full]
+ */
+smc_int32_t smc_waitset_add(smc_waitset_t *set,
+                            void *object,
+                            smc_list_head_t *head,
+                            smc_int32_t (*take)(void *object));
+
+#ifdef SMC_USING_SEMAPHORE
+/**
+ * This function will add a semaphore to wait set
+ *
+ * @param set [the wait set]
+ * @param sem [the semaphore]
+ *
+ * @return    [the index of semaphore in wait set, -SMC_NOMEM if it's full]
+ */
+smc_int32_t smc_waitset_add_sem(smc_waitset_t *set, smc_sem_t *sem);
+#endif
+
+/**
+ * This function will wait until any object in wait set is available, and
+ * take it.
+ *
+ * @param set      [the wait set]
+ * @param time_out [the waiting time]
+ *
+ * @return         [the index of the taken object, -SMC_TIMEOUT if time out]
+ */
+smc_int32_t smc_waitset_wait(smc_waitset_t *set, smc_int32_t time_out);
+
+/**
+ * This function will notify all the poll nodes in poll list of an object
+ *
+ * @param head [the poll list of object]
+ *
+ * @return     [1 if any node is notified, 0 if the list is empty]
+ *
+ * @note       [it must be invoked with interrupt disabled]
+ */
+smc_bool_t smc_poll_notify(smc_list_head_t *head);
+
+#endif /* SMC_USING_WAITSET */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_WAITSET_H
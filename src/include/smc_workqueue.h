@@ -0,0 +1,103 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-25
+ * Describe: This is a part of SMC-RTOS for work queue, many short deferred
+ *           works can share the stacks of a few worker threads.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#ifndef SMC_WORKQUEUE_H
+#define SMC_WORKQUEUE_H
+
+#include "smc_def.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef SMC_USING_WORKQUEUE
+
+#ifndef SMC_USING_SEMAPHORE
+#error work queue needs SMC_USING_SEMAPHORE
+#endif
+
+/**
+ * This function will initialize a work queue and its worker threads. The
+ * stacks of all workers are in one contiguous memory.
+ *
+ * @param wq          [the work queue]
+ * @param workers     [the static thread objects array of workers]
+ * @param worker_num  [the number of workers]
+ * @param stack_start [the start address of the stacks of all workers]
+ * @param stack_size  [the stack size of each worker]
+ * @param priority    [the priority of workers]
+ */
+void smc_workqueue_init(smc_workqueue_t *wq,
+                        smc_thread_t *workers,
+                        smc_uint8_t worker_num,
+                        void *stack_start,
+                        smc_uint32_t stack_size,
+                        smc_uint8_t priority);
+
+/**
+ * This function will initialize a work item
+ *
+ * @param work [the work item]
+ * @param func [the function of work]
+ * @param arg  [the argument of work function]
+ *
+ * @note       [the worker updates the work after its function returns, so]
+ * the function can't free the work item.
+ */
+void smc_work_init(smc_work_t *work, void (*func)(void *arg), void *arg);
+
+/**
+ * This function will submit a work item to work queue, it can be invoked
+ * in interrupt handle. A running work is queued again when its function
+ * returns, so it never runs on two workers at once.
+ *
+ * @param wq   [the work queue]
+ * @param work [the work item]
+ *
+ * @return     [SMC_OK on success, -SMC_BUSY if the work is pending]
+ */
+smc_int32_t smc_work_submit(smc_workqueue_t *wq, smc_work_t *work);
+
+/**
+ * This function will submit a work item to work queue after some ticks, it
+ * can be invoked in interrupt handle.
+ *
+ * @param wq   [the work queue]
+ * @param work [the work item]
+ * @param tick [the delay ticks]
+ *
+ * @return     [SMC_OK on success, -SMC_BUSY if the work is pending or]
+ * running.
+ */
+smc_int32_t smc_work_submit_delayed(smc_workqueue_t *wq,
+                                    smc_work_t *work,
+                                    smc_uint32_t tick);
+
+/**
+ * This function will cancel a pending work item, the submission during a
+ * run is cancelled too.
+ *
+ * @param work [the work item]
+ *
+ * @return     [SMC_OK on success, -SMC_BUSY if the work is running, and]
+ * -SMC_ERROR if the work is idle.
+ *
+ * @note       [a running work can't be cancelled, it goes on until its]
+ * function returns.
+ */
+smc_int32_t smc_work_cancel(smc_work_t *work);
+
+#endif /* SMC_USING_WORKQUEUE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SMC_WORKQUEUE_H
@@ -0,0 +1,123 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-20
+ * Describe: This is a part of SMC-RTOS for condition variable
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_cond.h"
+#include "smc_sem.h"
+#include "smc_thread.h"
+#include "smc_core.h"
+#include "smc_waitq.h"
+
+#ifdef SMC_USING_COND
+/**
+ * This function will initialize a condition variable
+ *
+ * @param cond   [the condition variable]
+ * @param policy [the wait queue policy of the suspended threads]
+ */
+void smc_cond_init(smc_cond_t *cond, smc_uint8_t policy)
+{
+	smc_waitq_init(&cond->waitq, policy);
+}
+
+/**
+ * This function will release the mutex and wait for the condition atomically,
+ * and the mutex is taken again before return, even if time out. The mutex
+ * is kept and -SMC_TIMEOUT is returned at once with SMC_COND_NO_WAIT.
+ *
+ * @param cond     [the condition variable]
+ * @param mutex    [the binary semaphore used as mutex, held by caller]
+ * @param time_out [the waiting time]
+ *
+ * @return         [error number]
+ */
+smc_int32_t smc_cond_wait(smc_cond_t *cond, smc_sem_t *mutex, smc_int32_t time_out)
+{
+	smc_uint32_t status;
+	smc_int32_t error_num;
+
+	/* the mutex is still held, nothing to wait for */
+	if (time_out == SMC_COND_NO_WAIT)
+		return -SMC_TIMEOUT;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	smc_waitq_suspend(&cond->waitq, time_out);
+
+	/**
+	 * The mutex is released after the thread is in the wait queue, so the
+	 * signal between them can't be lost.
+	 */
+	smc_sem_release(mutex);
+
+	smc_scheduler();
+
+	/* enable interrupt, and will make contex switch */
+	smc_cpu_enable_interrupt(status);
+
+	error_num = smc_thread_current->error_num;
+
+	smc_sem_pend(mutex, SMC_SEM_WAIT_FOREVER);
+
+	return error_num;
+}
+
+/**
+ * This function will wake up the first thread waiting for the condition
+ *
+ * @param cond [the condition variable]
+ *
+ * @return     [error number]
+ */
+smc_int32_t smc_cond_signal(smc_cond_t *cond)
+{
+	smc_thread_t *thread;
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	thread = smc_waitq_first(&cond->waitq);
+	if (thread)
+		smc_thread_resume(thread);
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	return SMC_OK;
+}
+
+/**
+ * This function will wake up all the threads waiting for the condition, and
+ * schedule only once.
+ *
+ * @param cond [the condition variable]
+ *
+ * @return     [error number]
+ */
+smc_int32_t smc_cond_broadcast(smc_cond_t *cond)
+{
+	smc_thread_t *thread;
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	while ((thread = smc_waitq_first(&cond->waitq)) != NULL)
+		smc_thread_wakeup(thread);
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	smc_scheduler();
+
+	return SMC_OK;
+}
+
+#endif /* SMC_USING_COND */
@@ -12,11 +12,17 @@
 #include "smc_list.h"
 #include "smc_timer.h"
 #include "smc_cpu.h"
+#include "smc_irqoff.h"
 
 static void (*smc_scheduler_hook)(void);
-smc_uint32_t smc_bitmap_group;                     /* thread priority bit map */
+volatile smc_uint32_t smc_bitmap_group;            /* thread priority bit map */
 static smc_uint8_t smc_scheduler_lock_count;       /* the scheduler lock nest */
 static volatile smc_uint8_t smc_interrupt_nest;
+static volatile smc_uint8_t smc_need_resched;       /* reschedule at the outermost interrupt exit */
+static volatile smc_uint32_t smc_tick;              /* the ticks since startup */
+#if defined(SMC_USING_THREAD_STATS) || defined(SMC_USING_PM) || defined(SMC_USING_WAKEUP_LATENCY)
+static volatile smc_uint32_t smc_tick_cycle;        /* the cpu cycle of the last tick */
+#endif
 
 /**
  * This function finds the first bit set (beginning with the least significant bit)
@@ -28,12 +34,48 @@ static volatile smc_uint8_t smc_interrupt_nest;
  * @return return the index of the first bit set. If value is 0, then this function
  * shall return 0.
  */
+#if defined(__CC_ARM)
 __asm static smc_uint32_t __bit_search(smc_uint32_t value)
 {
 	RBIT    R0, R0                            /* reversal RO for bit */
 	CLZ     R0, R0                            /* Count Leading Zeros */
 	BX      LR
 }
+#elif defined(__GNUC__) && (defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__))
+smc_inline smc_uint32_t __bit_search(smc_uint32_t value)
+{
+	/* GCC emits RBIT + CLZ for the Cortex-M3/M4 */
+	return value ? __builtin_ctz(value) : 0;
+}
+#else
+/**
+ * Portable version for the cores without a count-leading-zeros instruction
+ * (e.g. RV32IMAC). The lowest set bit is isolated and a de Bruijn sequence
+ * multiplication maps it to a unique index of the table.
+ */
+static const smc_uint8_t __debruijn_bit_table[32] = {
+	0,  1,  28, 2,  29, 14, 24, 3,  30, 22, 20, 15, 25, 17, 4,  8,
+	31, 27, 13, 23, 21, 19, 16, 7,  26, 12, 18, 6,  11, 5,  10, 9
+};
+
+smc_inline smc_uint32_t __bit_search(smc_uint32_t value)
+{
+	return __debruijn_bit_table[((value & (~value + 1U)) * 0x077CB531U) >> 27];
+}
+#endif
+
+/**
+ * The function will find the first bit set (beginning with the least
+ * significant bit) in value.
+ *
+ * @param value [the value to be searched]
+ *
+ * @return      [the index of the first bit set, 0 if value is 0]
+ */
+smc_uint8_t smc_bit_search(smc_uint32_t value)
+{
+	return __bit_search(value);
+}
 
 /**
  * The function will get the highest priority
@@ -49,6 +91,10 @@ smc_uint8_t smc_get_highest_prio(void)
  */
 void smc_time_tick(void)
 {
+#if defined(SMC_USING_THREAD_STATS) || defined(SMC_USING_PM) || defined(SMC_USING_WAKEUP_LATENCY)
+	smc_tick_cycle = smc_cpu_cycle_get();
+#endif
+	smc_tick++;
 	smc_timer_decrease();
 	smc_thread_current->remaining_slice_tick--;
 	if (smc_thread_current->remaining_slice_tick == 0U) {
@@ -58,15 +104,24 @@ void smc_time_tick(void)
 }
 
 /**
- * This function will perform one schedule. It will select one thread
- * with the highest priority level, then switch to it.
+ * This function will return the ticks since system startup
+ *
+ * @return  [the current tick]
  */
-void smc_scheduler(void)
+smc_uint32_t smc_tick_get(void)
 {
-	smc_uint32_t status;
+	return smc_tick;
+}
 
-	if (smc_scheduler_lock_count)
-		return;
+/**
+ * This function will select the thread with the highest priority level,
+ * then switch to it.
+ *
+ * @param in_interrupt [whether it's invoked in interrupt service routine]
+ */
+static void smc_scheduler_switch(smc_bool_t in_interrupt)
+{
+	smc_uint32_t status;
 
 	status = smc_cpu_disable_interrupt();
 	smc_thread_ready = smc_thread_highest_ready();
@@ -77,13 +132,55 @@ void smc_scheduler(void)
 		if (smc_scheduler_hook)
 			smc_scheduler_hook();
 		/* switch to new thread */
-		if (smc_interrupt_nest > 0U)
+		if (in_interrupt)
 			smc_thread_intrrupt_switch();
 		else
 			smc_thread_switch();
 	}
 }
 
+#if defined(SMC_USING_THREAD_STATS) || defined(SMC_USING_PM) || defined(SMC_USING_WAKEUP_LATENCY)
+/**
+ * This function will return the current tick and the cpu cycle when it
+ * started.
+ *
+ * @param cycle [the cpu cycle of the tick interrupt]
+ *
+ * @return      [the current tick]
+ */
+smc_uint32_t smc_tick_get_stamp(smc_uint32_t *cycle)
+{
+	smc_uint32_t status;
+	smc_uint32_t tick;
+
+	status = smc_cpu_disable_interrupt();
+	tick   = smc_tick;
+	*cycle = smc_tick_cycle;
+	smc_cpu_enable_interrupt(status);
+
+	return tick;
+}
+#endif
+
+/**
+ * This function will perform one schedule. It will select one thread
+ * with the highest priority level, then switch to it. In interrupt service
+ * routine, it only marks that a reschedule is needed, and the decision is
+ * made once by smc_exit_interrupt().
+ */
+void smc_scheduler(void)
+{
+	if (smc_scheduler_lock_count)
+		return;
+
+	if (smc_interrupt_nest > 0U) {
+		smc_need_resched = 1;
+		return;
+	}
+
+	smc_scheduler_switch(0);
+}
+
 /**
  * This function will lock the thread scheduler.
  */
@@ -110,6 +207,20 @@ void smc_scheduler_unlock(void)
 	}
 }
 
+/**
+ * This function will return whether the current context can be blocked. It
+ * can't be blocked in interrupt, before scheduler startup and with scheduler
+ * locked.
+ *
+ * @return  [1 on blockable, 0 on not]
+ */
+smc_bool_t smc_scheduler_is_blockable(void)
+{
+	return smc_thread_current != NULL &&
+	       smc_interrupt_nest == 0U &&
+	       smc_scheduler_lock_count == 0U;
+}
+
 /**
  * This function will init SMC-RTOS
  */
@@ -126,6 +237,9 @@ void smc_rtos_init(void)
  */
 void smc_rtos_scheduler(void)
 {
+#ifdef SMC_USING_IRQOFF_PROFILE
+	smc_irqoff_start();
+#endif
 	smc_thread_current = NULL;
 
 	/**
@@ -187,6 +301,16 @@ void smc_exit_interrupt(void)
 	/* disable intrrupt */
 	status = smc_cpu_disable_interrupt();
 	smc_interrupt_nest--;
+
+	/* the outermost interrupt makes the only scheduling decision */
+	if (smc_interrupt_nest == 0U && smc_need_resched) {
+		smc_need_resched = 0;
+		smc_cpu_enable_interrupt(status);
+
+		if (smc_scheduler_lock_count == 0U)
+			smc_scheduler_switch(1);
+		return;
+	}
 	/* enable intrrupt */
 	smc_cpu_enable_interrupt(status);
 }
@@ -0,0 +1,211 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-06
+ * Describe: This is a part of SMC-RTOS for high-resolution timer
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_hrtimer.h"
+#include "smc_list.h"
+#include "smc_cpu.h"
+#include "smc_core.h"
+
+#ifdef SMC_USING_HRTIMER
+
+#if (SMC_HRTIMER_COUNTER_HZ % 1000000) != 0
+#error SMC_HRTIMER_COUNTER_HZ must be multiple of 1MHz
+#endif
+
+#define SMC_HRTIMER_COUNT_PER_US    (SMC_HRTIMER_COUNTER_HZ / 1000000)
+
+/**
+ * The counter is extended to 64bit by software, so it must be read once
+ * in half a wrap at least. The compare is never armed further than it.
+ */
+#define SMC_HRTIMER_MAX_DELTA       0x7FFFFFFFU
+
+static smc_list_head_t smc_hrtimer_list =
+	LIST_NODE_INIT(smc_hrtimer_list);                /* active timer list sorted by expiry */
+
+static smc_uint32_t smc_hrtimer_last;                    /* the last read counter */
+static smc_uint32_t smc_hrtimer_wrap;                    /* the counter wrap times */
+
+/**
+ * This function will return the 64bit counter, it must be invoked with
+ * interrupt disabled.
+ *
+ * @return [the 64bit counter]
+ */
+static smc_uint64_t smc_hrtimer_count(void)
+{
+	smc_uint32_t now = smc_hw_hrtimer_read();
+
+	if (now < smc_hrtimer_last)
+		smc_hrtimer_wrap++;
+	smc_hrtimer_last = now;
+
+	return ((smc_uint64_t)smc_hrtimer_wrap << 32) | now;
+}
+
+/**
+ * This function will arm the compare for the first timer in list, it must
+ * be invoked with interrupt disabled.
+ *
+ * @param now [the current 64bit counter]
+ */
+static void smc_hrtimer_program(smc_uint64_t now)
+{
+	smc_uint64_t next = now + SMC_HRTIMER_MAX_DELTA;
+
+	if (!smc_list_is_empty(&smc_hrtimer_list)) {
+		smc_hrtimer_t *timer = smc_list_first_entry(&smc_hrtimer_list,
+		                                            smc_hrtimer_t,
+		                                            hlist);
+
+		if (timer->expires < next)
+			next = timer->expires;
+	}
+
+	smc_hw_hrtimer_set_compare((smc_uint32_t)next);
+}
+
+/**
+ * This function will init a high-resolution timer
+ *
+ * @param timer     [the timer to be initialized]
+ * @param timeout   [the function will be invoked when the timer expires]
+ * @param parameter [the function parameter]
+ */
+void smc_hrtimer_init(smc_hrtimer_t *timer,
+                      void (*timeout)(void *parameter),
+                      void *parameter)
+{
+	timer->timeout   = timeout;
+	timer->parameter = parameter;
+	timer->expires   = 0;
+	timer->active    = 0;
+	smc_list_node_init(&timer->hlist);
+}
+
+/**
+ * This function will start a one-shot high-resolution timer, if the timer
+ * is active, it will be restarted.
+ *
+ * @param timer [the timer to be started]
+ * @param us    [the microseconds from now]
+ */
+void smc_hrtimer_start(smc_hrtimer_t *timer, smc_uint32_t us)
+{
+	smc_list_node_t *pos;
+	smc_uint64_t now;
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	if (timer->active)
+		smc_list_del_entry(&timer->hlist);
+
+	now            = smc_hrtimer_count();
+	timer->expires = now + (smc_uint64_t)us * SMC_HRTIMER_COUNT_PER_US;
+	timer->active  = 1;
+
+	/* find the position, the timers of same expiry keep the start order */
+	for (pos = smc_hrtimer_list.next; pos != &smc_hrtimer_list; pos = pos->next) {
+		smc_hrtimer_t *t = smc_list_entry(pos, smc_hrtimer_t, hlist);
+
+		if (t->expires > timer->expires)
+			break;
+	}
+	smc_list_add_tail(&timer->hlist, pos);
+
+	/* the timer is the first one, the compare should be changed */
+	if (smc_hrtimer_list.next == &timer->hlist)
+		smc_hrtimer_program(now);
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+}
+
+/**
+ * This function will cancel a high-resolution timer
+ *
+ * @param timer [the timer to be cancelled]
+ */
+void smc_hrtimer_cancel(smc_hrtimer_t *timer)
+{
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	/**
+	 * The compare is not changed, it will be re-armed by smc_hrtimer_isr()
+	 * with nothing expired.
+	 */
+	if (timer->active) {
+		smc_list_del_entry(&timer->hlist);
+		timer->active = 0;
+	}
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+}
+
+/**
+ * This function will return the monotonic time since the high-resolution
+ * counter starts.
+ *
+ * @return [the microseconds]
+ */
+smc_uint64_t smc_time_now_us(void)
+{
+	smc_uint64_t count;
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+	count  = smc_hrtimer_count();
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	return count / SMC_HRTIMER_COUNT_PER_US;
+}
+
+/**
+ * The function will process the expired high-resolution timers, it should be
+ * invoked by the compare interrupt handle of BSP.
+ */
+void smc_hrtimer_isr(void)
+{
+	smc_uint64_t now;
+	smc_uint32_t status = smc_cpu_disable_interrupt();
+
+	now = smc_hrtimer_count();
+	while (!smc_list_is_empty(&smc_hrtimer_list)) {
+		smc_hrtimer_t *timer = smc_list_first_entry(&smc_hrtimer_list,
+		                                            smc_hrtimer_t,
+		                                            hlist);
+
+		if (timer->expires > now)
+			break;
+
+		smc_list_del_entry(&timer->hlist);
+		timer->active = 0;
+		timer->timeout(timer->parameter);
+
+		/* the timeout function may take some time */
+		now = smc_hrtimer_count();
+	}
+	smc_hrtimer_program(now);
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	/* do scheduler */
+	smc_scheduler();
+}
+
+#endif /* SMC_USING_HRTIMER */
@@ -10,6 +10,7 @@
 #include "smc_idle.h"
 #include "smc_thread.h"
 #include "smc_timer.h"
+#include "smc_pm.h"
 
 /**
  * The idle thread stack definition
@@ -152,5 +153,8 @@ void idle_thread_entry(void *parameter)
 #endif
 		if (smc_thread_idle_hook)
 			smc_thread_idle_hook();
+#ifdef SMC_USING_PM
+		smc_pm_idle();
+#endif
 	}
 }
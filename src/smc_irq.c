@@ -0,0 +1,162 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-01
+ * Describe: This is a part of SMC-RTOS for threaded interrupt, the top half
+ *           acknowledges the hardware and a thread handles the interrupt.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_irq.h"
+#include "smc_thread.h"
+#include "smc_cpu.h"
+
+#ifdef SMC_USING_THREADED_IRQ
+
+static smc_irq_desc_t *smc_irq_table[SMC_IRQ_MAX];         /* threaded interrupt descriptors */
+
+/**
+ * The entry function of interrupt handler thread
+ *
+ * @param parameter [the interrupt descriptor]
+ */
+static void smc_irq_thread_entry(void *parameter)
+{
+	smc_irq_desc_t *desc = (smc_irq_desc_t *)parameter;
+	smc_uint32_t status;
+	smc_uint32_t latency;
+
+	while (1) {
+		/* disable interrupt */
+		status = smc_cpu_disable_interrupt();
+
+		if (!desc->pending) {
+			smc_thread_suspend(smc_thread_current);
+
+			smc_scheduler();
+
+			/* enable interrupt, and will make contex switch */
+			smc_cpu_enable_interrupt(status);
+			continue;
+		}
+
+		desc->pending = 0;
+		latency = smc_cpu_cycle_get() - desc->stamp;
+
+		/* enable interrupt */
+		smc_cpu_enable_interrupt(status);
+
+		if (latency < desc->latency_min)
+			desc->latency_min = latency;
+		if (latency > desc->latency_max)
+			desc->latency_max = latency;
+		desc->latency_sum += latency;
+		desc->count++;
+
+		desc->handler(desc->arg);
+
+		smc_cpu_irq_unmask(desc->irq);
+	}
+}
+
+/**
+ * This function will request a threaded interrupt, the handler thread is
+ * created and the interrupt is unmasked.
+ *
+ * @param desc        [the interrupt descriptor]
+ * @param irq         [the interrupt number]
+ * @param ack         [the top half to acknowledge the hardware, can be NULL]
+ * @param handler     [the function run in handler thread]
+ * @param arg         [the argument of ack and handler]
+ * @param priority    [the priority of handler thread]
+ * @param stack_start [the start address of handler thread stack]
+ * @param stack_size  [the size of handler thread stack]
+ *
+ * @return            [SMC_OK on success, -SMC_BUSY if irq is requested]
+ */
+smc_int32_t smc_irq_request(smc_irq_desc_t *desc,
+                            smc_uint32_t irq,
+                            void (*ack)(void *arg),
+                            void (*handler)(void *arg),
+                            void *arg,
+                            smc_uint8_t priority,
+                            void *stack_start,
+                            smc_uint32_t stack_size)
+{
+	if (irq >= SMC_IRQ_MAX || smc_irq_table[irq])
+		return -SMC_BUSY;
+
+	desc->ack     = ack;
+	desc->handler = handler;
+	desc->arg     = arg;
+	desc->irq     = irq;
+	desc->pending = 0;
+	smc_irq_stats_reset(desc);
+
+	smc_thread_init(&desc->thread,
+	                smc_irq_thread_entry,
+	                desc,
+	                priority,
+	                stack_start,
+	                stack_size,
+	                SMC_IRQ_SLICE_TICK);
+
+	smc_irq_table[irq] = desc;
+	smc_cpu_irq_unmask(irq);
+
+	return SMC_OK;
+}
+
+/**
+ * This function is the top half of threaded interrupt, it should be invoked
+ * by the interrupt vector between smc_enter_interrupt() and
+ * smc_exit_interrupt(). The interrupt is masked until the handler returns.
+ *
+ * @param irq [the interrupt number]
+ *
+ * @return    [SMC_OK on success, -SMC_ERROR if irq isn't requested]
+ */
+smc_int32_t smc_irq_dispatch(smc_uint32_t irq)
+{
+	smc_irq_desc_t *desc;
+	smc_uint32_t status;
+
+	if (irq >= SMC_IRQ_MAX || !(desc = smc_irq_table[irq]))
+		return -SMC_ERROR;
+
+	if (desc->ack)
+		desc->ack(desc->arg);
+
+	smc_cpu_irq_mask(irq);
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	desc->stamp   = smc_cpu_cycle_get();
+	desc->pending = 1;
+	smc_thread_wakeup(&desc->thread);
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	/* it's only marked, and the handler thread runs after interrupt exit */
+	smc_scheduler();
+
+	return SMC_OK;
+}
+
+/**
+ * This function will reset the latency statistics of threaded interrupt
+ *
+ * @param desc [the interrupt descriptor]
+ */
+void smc_irq_stats_reset(smc_irq_desc_t *desc)
+{
+	desc->count       = 0;
+	desc->latency_min = 0xFFFFFFFFU;
+	desc->latency_max = 0;
+	desc->latency_sum = 0;
+}
+
+#endif /* SMC_USING_THREADED_IRQ */
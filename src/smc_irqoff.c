@@ -0,0 +1,221 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-07
+ * Describe: This is a part of SMC-RTOS for interrupt disabled time profiler,
+ *           the critical sections are measured by cpu cycle counter and
+ *           recorded per call site.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_irqoff.h"
+#include "smc_cpu.h"
+
+#ifdef SMC_USING_IRQOFF_PROFILE
+
+/**
+ * The original functions of port are invoked by the parenthesized names,
+ * which are not expanded by the profiling macros in smc_cpu.h.
+ */
+#define smc_irqoff_disable()        (smc_cpu_disable_interrupt)()
+#define smc_irqoff_enable(status)   (smc_cpu_enable_interrupt)(status)
+
+static smc_irqoff_site_t smc_irqoff_table[SMC_IRQOFF_SITE_MAX];
+static smc_uint32_t smc_irqoff_depth;                     /* nesting of critical section */
+static const char *smc_irqoff_file;                       /* the outermost call site */
+static smc_uint32_t smc_irqoff_line;
+static smc_uint32_t smc_irqoff_stamp;                     /* the cpu cycle of disabling */
+static smc_uint32_t smc_irqoff_drop;
+
+/**
+ * This function will find the slot of call site, a free slot is taken if it
+ * isn't recorded.
+ *
+ * @param file [the file of call site]
+ * @param line [the line of call site]
+ *
+ * @return     [the slot, NULL if the table is full]
+ */
+static smc_irqoff_site_t *smc_irqoff_lookup(const char *file, smc_uint32_t line)
+{
+	smc_uint32_t index = (line * 2654435761U ^ (smc_uint32_t)file) % SMC_IRQOFF_SITE_MAX;
+	smc_uint32_t i;
+
+	/* linear probing */
+	for (i = 0; i < SMC_IRQOFF_SITE_MAX; i++) {
+		smc_irqoff_site_t *site = &smc_irqoff_table[index];
+
+		if (site->file == NULL) {
+			site->file = file;
+			site->line = line;
+			return site;
+		}
+		if (site->file == file && site->line == line)
+			return site;
+
+		if (++index == SMC_IRQOFF_SITE_MAX)
+			index = 0;
+	}
+
+	return NULL;
+}
+
+/**
+ * This function will record an outermost critical section, it's invoked with
+ * interrupt disabled.
+ *
+ * @param cycles [the interrupt disabled cycles]
+ */
+static void smc_irqoff_record(smc_uint32_t cycles)
+{
+	smc_irqoff_site_t *site = smc_irqoff_lookup(smc_irqoff_file, smc_irqoff_line);
+	smc_uint8_t bucket = 0;
+
+	if (site == NULL) {
+		smc_irqoff_drop++;
+		return;
+	}
+
+	site->count++;
+	site->sum += cycles;
+	if (cycles > site->max)
+		site->max = cycles;
+
+	/* bucket n counts cycles in [2^(n-1), 2^n), the last counts the rest */
+	while (cycles != 0U && bucket < SMC_IRQOFF_HIST_BUCKETS - 1) {
+		cycles >>= 1;
+		bucket++;
+	}
+	site->hist[bucket]++;
+}
+
+/**
+ * This function will disable interrupt, and stamp the call site if it's the
+ * outermost critical section.
+ *
+ * @param file [the file of call site]
+ * @param line [the line of call site]
+ *
+ * @return     [the interrupt status before disabled]
+ */
+smc_uint32_t smc_irqoff_enter(const char *file, smc_uint32_t line)
+{
+	smc_uint32_t status = smc_irqoff_disable();
+
+	if (smc_irqoff_depth++ == 0U) {
+		smc_irqoff_file  = file;
+		smc_irqoff_line  = line;
+		smc_irqoff_stamp = smc_cpu_cycle_get();
+	}
+
+	return status;
+}
+
+/**
+ * This function will restore interrupt status, and record the call site if
+ * it's the outermost critical section.
+ *
+ * @param status [the interrupt status returned by smc_irqoff_enter()]
+ */
+void smc_irqoff_exit(smc_uint32_t status)
+{
+	smc_uint32_t cycles = smc_cpu_cycle_get() - smc_irqoff_stamp;
+
+	/* the unpaired enabling is ignored */
+	if (smc_irqoff_depth > 0U && --smc_irqoff_depth == 0U)
+		smc_irqoff_record(cycles);
+
+	smc_irqoff_enable(status);
+}
+
+/**
+ * This function will reset the nesting and the records, it's invoked by
+ * smc_rtos_scheduler() because interrupt is disabled without pair before
+ * the system starts.
+ */
+void smc_irqoff_start(void)
+{
+	smc_irqoff_depth = 0;
+	smc_irqoff_reset();
+}
+
+/**
+ * This function will clear the records of all call sites
+ */
+void smc_irqoff_reset(void)
+{
+	smc_uint32_t status;
+	smc_uint32_t i, j;
+
+	for (i = 0; i < SMC_IRQOFF_SITE_MAX; i++) {
+		smc_irqoff_site_t *site = &smc_irqoff_table[i];
+
+		status = smc_irqoff_disable();
+		site->file  = NULL;
+		site->line  = 0;
+		site->count = 0;
+		site->max   = 0;
+		site->sum   = 0;
+		for (j = 0; j < SMC_IRQOFF_HIST_BUCKETS; j++)
+			site->hist[j] = 0;
+		smc_irqoff_enable(status);
+	}
+
+	smc_irqoff_drop = 0;
+}
+
+/**
+ * This function will report the worst call sites ordered by the maximum
+ * interrupt disabled cycles. Each site is copied with interrupt disabled
+ * briefly, so it can be invoked while the system is running.
+ *
+ * @param sites [the array to store the copies of sites]
+ * @param num   [the size of array]
+ *
+ * @return      [how many sites are stored]
+ */
+smc_uint32_t smc_irqoff_report(smc_irqoff_site_t *sites, smc_uint32_t num)
+{
+	smc_irqoff_site_t site;
+	smc_uint32_t status;
+	smc_uint32_t count = 0;
+	smc_uint32_t i, j;
+
+	if (num == 0U)
+		return 0;
+
+	for (i = 0; i < SMC_IRQOFF_SITE_MAX; i++) {
+		status = smc_irqoff_disable();
+		site   = smc_irqoff_table[i];
+		smc_irqoff_enable(status);
+
+		if (site.file == NULL || site.count == 0U)
+			continue;
+		if (count == num && site.max <= sites[count - 1].max)
+			continue;
+
+		/* insertion sort, the last one is dropped if the array is full */
+		j = count < num ? count++ : count - 1;
+		while (j > 0U && sites[j - 1].max < site.max) {
+			sites[j] = sites[j - 1];
+			j--;
+		}
+		sites[j] = site;
+	}
+
+	return count;
+}
+
+/**
+ * This function will return how many critical sections are not recorded
+ * because the site table is full.
+ *
+ * @return [the dropped count]
+ */
+smc_uint32_t smc_irqoff_dropped(void)
+{
+	return smc_irqoff_drop;
+}
+
+#endif /* SMC_USING_IRQOFF_PROFILE */
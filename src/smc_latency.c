@@ -0,0 +1,99 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-09
+ * Describe: This is a part of SMC-RTOS for wakeup-to-run latency, the time
+ *           from a thread becoming ready to its first instruction after the
+ *           context switch is recorded per priority.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_latency.h"
+#include "smc_cpu.h"
+
+#ifdef SMC_USING_WAKEUP_LATENCY
+
+static smc_latency_t smc_latency_table[SMC_PRIORITY_MAX];
+
+/**
+ * This function will record the latency of the thread switched in, it's
+ * invoked by the port with interrupt disabled after smc_thread_current is
+ * updated.
+ *
+ * @param thread [the thread switched in]
+ */
+void smc_latency_switch_in(smc_thread_t *thread)
+{
+	smc_latency_t *latency;
+	smc_uint32_t cycles;
+	smc_uint8_t bucket = 0;
+
+	/* the preempted thread is ready already, it isn't waked */
+	if (!thread->wake_pending)
+		return;
+
+	cycles               = smc_cpu_cycle_get() - thread->wake_cycle;
+	thread->wake_pending = 0;
+	latency              = &smc_latency_table[thread->priority];
+
+	latency->count++;
+	latency->sum += cycles;
+	if (cycles > latency->max)
+		latency->max = cycles;
+
+	/* bucket n counts cycles in [2^(n-1), 2^n), the last counts the rest */
+	while (cycles != 0U && bucket < SMC_LATENCY_BUCKETS - 1) {
+		cycles >>= 1;
+		bucket++;
+	}
+	latency->hist[bucket]++;
+}
+
+/**
+ * This function will get the latency of a priority. The histogram bucket n
+ * counts the cycles in [2^(n-1), 2^n), and the last counts the rest.
+ *
+ * @param priority [the priority]
+ * @param latency  [the copy of latency]
+ *
+ * @return         [SMC_OK on success, -SMC_ERROR if priority is invalid]
+ */
+smc_int32_t smc_latency_get(smc_uint8_t priority, smc_latency_t *latency)
+{
+	smc_uint32_t status;
+
+	if (priority >= SMC_PRIORITY_MAX)
+		return -SMC_ERROR;
+
+	/* disable interrupt */
+	status   = smc_cpu_disable_interrupt();
+	*latency = smc_latency_table[priority];
+	smc_cpu_enable_interrupt(status);
+
+	return SMC_OK;
+}
+
+/**
+ * This function will clear the latency of all priorities
+ */
+void smc_latency_reset(void)
+{
+	smc_uint32_t status;
+	smc_uint32_t i, j;
+
+	for (i = 0; i < SMC_PRIORITY_MAX; i++) {
+		smc_latency_t *latency = &smc_latency_table[i];
+
+		/* disable interrupt */
+		status         = smc_cpu_disable_interrupt();
+		latency->count = 0;
+		latency->max   = 0;
+		latency->sum   = 0;
+		for (j = 0; j < SMC_LATENCY_BUCKETS; j++)
+			latency->hist[j] = 0;
+		smc_cpu_enable_interrupt(status);
+	}
+}
+
+#endif /* SMC_USING_WAKEUP_LATENCY */
@@ -0,0 +1,218 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-08
+ * Describe: This is a part of SMC-RTOS for lock contention statistics, the
+ *           locks are enumerated through a registry.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_lockstat.h"
+#include "smc_list.h"
+#include "smc_thread.h"
+#include "smc_cpu.h"
+
+#ifdef SMC_USING_LOCK_STATS
+
+static smc_list_head_t smc_lockstat_list = LIST_NODE_INIT(smc_lockstat_list);  /* registered locks */
+static smc_uint32_t smc_lockstat_gen;                                       /* changed by unregister */
+
+/**
+ * This function will clear the counters of statistics
+ *
+ * @param stat [the statistics]
+ */
+static void smc_lockstat_clear(smc_lockstat_t *stat)
+{
+	stat->pends           = 0;
+	stat->contended       = 0;
+	stat->timeouts        = 0;
+	stat->wait_max        = 0;
+	stat->wait_sum        = 0;
+	stat->wait_max_thread = NULL;
+}
+
+/**
+ * This function will initialize the statistics, it's invoked by the init
+ * function of lock. A registered lock should be unregistered before it's
+ * initialized again.
+ *
+ * @param stat [the statistics]
+ */
+void smc_lockstat_init(smc_lockstat_t *stat)
+{
+	smc_list_node_init(&stat->list);
+	stat->name = NULL;
+	smc_lockstat_clear(stat);
+}
+
+/**
+ * This function will count a contended pend, it should be invoked with
+ * interrupt disabled.
+ *
+ * @param stat [the statistics]
+ *
+ * @return     [the cpu cycle when the thread starts waiting]
+ */
+smc_uint32_t smc_lockstat_contend(smc_lockstat_t *stat)
+{
+	stat->contended++;
+
+	return smc_cpu_cycle_get();
+}
+
+/**
+ * This function will record the blocked time after the thread is waked, it
+ * should be invoked with interrupt enabled.
+ *
+ * @param stat      [the statistics]
+ * @param stamp     [the cycle returned by smc_lockstat_contend()]
+ * @param error_num [the result of waiting]
+ */
+void smc_lockstat_wait_done(smc_lockstat_t *stat,
+                            smc_uint32_t stamp,
+                            smc_int32_t error_num)
+{
+	smc_uint32_t wait = smc_cpu_cycle_get() - stamp;
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	stat->wait_sum += wait;
+	if (wait > stat->wait_max) {
+		stat->wait_max        = wait;
+		stat->wait_max_thread = smc_thread_current;
+	}
+	if (error_num == -SMC_TIMEOUT)
+		stat->timeouts++;
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+}
+
+/**
+ * This function will add the statistics of a lock to registry, e.g.
+ *
+ *   smc_lockstat_register(&sem.stats, "uart tx");
+ *
+ * @param stat [the statistics]
+ * @param name [the name of lock]
+ *
+ * @return     [SMC_OK on success, -SMC_BUSY if it's registered]
+ */
+smc_int32_t smc_lockstat_register(smc_lockstat_t *stat, const char *name)
+{
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	if (!smc_list_is_empty(&stat->list)) {
+		smc_cpu_enable_interrupt(status);
+		return -SMC_BUSY;
+	}
+
+	stat->name = name;
+	smc_list_add_tail(&stat->list, &smc_lockstat_list);
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	return SMC_OK;
+}
+
+/**
+ * This function will remove the statistics of a lock from registry
+ *
+ * @param stat [the statistics]
+ */
+void smc_lockstat_unregister(smc_lockstat_t *stat)
+{
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+	smc_list_del_entry(&stat->list);
+	smc_lockstat_gen++;
+	smc_cpu_enable_interrupt(status);
+}
+
+/**
+ * This function will clear the statistics, the registry is kept.
+ *
+ * @param stat [the statistics]
+ */
+void smc_lockstat_reset(smc_lockstat_t *stat)
+{
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+	smc_lockstat_clear(stat);
+	smc_cpu_enable_interrupt(status);
+}
+
+/**
+ * This function will report the registered locks ordered by the total
+ * blocked time. Each lock is copied with interrupt disabled briefly, so it
+ * can be invoked while the system is running. The walk starts again if a
+ * lock is unregistered meanwhile.
+ *
+ * @param stats [the array to store the copies of statistics]
+ * @param num   [the size of array]
+ *
+ * @return      [how many locks are stored]
+ */
+smc_uint32_t smc_lockstat_report(smc_lockstat_t *stats, smc_uint32_t num)
+{
+	smc_list_node_t *node;
+	smc_lockstat_t stat;
+	smc_uint32_t status;
+	smc_uint32_t count = 0;
+	smc_uint32_t gen;
+	smc_uint32_t i;
+
+	if (num == 0U)
+		return 0;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	node = smc_lockstat_list.next;
+	gen  = smc_lockstat_gen;
+	while (node != &smc_lockstat_list) {
+		stat = *smc_list_entry(node, smc_lockstat_t, list);
+		node = node->next;
+
+		/* let the interrupt in between */
+		smc_cpu_enable_interrupt(status);
+
+		if (count < num || stat.wait_sum > stats[count - 1].wait_sum) {
+			/* insertion sort, the last one is dropped if the array is full */
+			i = count < num ? count++ : count - 1;
+			while (i > 0U && stats[i - 1].wait_sum < stat.wait_sum) {
+				stats[i] = stats[i - 1];
+				i--;
+			}
+			stats[i] = stat;
+		}
+
+		status = smc_cpu_disable_interrupt();
+
+		/* the next node may be unregistered meanwhile, walk again */
+		if (gen != smc_lockstat_gen) {
+			node  = smc_lockstat_list.next;
+			gen   = smc_lockstat_gen;
+			count = 0;
+		}
+	}
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	return count;
+}
+
+#endif /* SMC_USING_LOCK_STATS */
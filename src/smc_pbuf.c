@@ -0,0 +1,449 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-11
+ * Describe: This is a part of SMC-RTOS for packet buffer, the fixed size
+ *           buffers are allocated from pools, chained for large payload and
+ *           shared by reference count.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include <string.h>
+#include "smc_pbuf.h"
+#include "smc_sem.h"
+#include "smc_waitq.h"
+#include "smc_thread.h"
+#include "smc_core.h"
+#include "smc_cpu.h"
+#include "smc_atomic.h"
+
+#ifdef SMC_USING_PBUF
+
+#define smc_pbuf_data(p)            ((smc_uint8_t *)((p) + 1))
+
+/**
+ * This function will initialize a pool
+ *
+ * @param pool     [the pool]
+ * @param memory   [the memory of buffers, 4-bytes aligned]
+ * @param size     [the size of memory]
+ * @param buf_size [data bytes of a buffer]
+ *
+ * @return         [SMC_OK on success, -SMC_NOMEM if memory holds no buffer]
+ */
+smc_int32_t smc_pbuf_pool_init(smc_pbuf_pool_t *pool,
+                               void *memory,
+                               smc_uint32_t size,
+                               smc_uint16_t buf_size)
+{
+	smc_uint32_t elem = SMC_ALIGN(sizeof(smc_pbuf_t) + buf_size, 4);
+	smc_uint32_t num  = size / elem;
+	smc_uint32_t i;
+
+	/* the free buffers are counted in 16bit */
+	if (num > 0xFFFFU)
+		num = 0xFFFFU;
+	if (num == 0U || buf_size == 0U)
+		return -SMC_NOMEM;
+
+	pool->free     = NULL;
+	pool->avail    = num;
+	pool->buf_size = buf_size;
+	pool->num      = num;
+
+	for (i = 0; i < num; i++) {
+		smc_pbuf_t *p = (smc_pbuf_t *)((smc_uint8_t *)memory + i * elem);
+
+		p->pool    = pool;
+		p->next    = pool->free;
+		pool->free = p;
+	}
+
+	smc_waitq_init(&pool->waitq, SMC_WAITQ_PRIO);
+
+	return SMC_OK;
+}
+
+/**
+ * This function will return a buffer to its pool
+ *
+ * @param p [the buffer]
+ */
+static void smc_pbuf_pool_put(smc_pbuf_t *p)
+{
+	smc_pbuf_pool_t *pool = p->pool;
+	smc_thread_t *thread;
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status     = smc_cpu_disable_interrupt();
+	p->next    = pool->free;
+	pool->free = p;
+	pool->avail++;
+
+	/* wake all the waiters, each one checks its own request again */
+	if ((thread = smc_waitq_first(&pool->waitq)) != NULL) {
+		do {
+			smc_thread_wakeup(thread);
+		} while ((thread = smc_waitq_first(&pool->waitq)) != NULL);
+		smc_scheduler();
+	}
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+}
+
+/**
+ * This function will allocate a chain holding len bytes, the first buffer
+ * reserves headroom for the headers prepended later. The reference count is
+ * one. The caller waits until the pool has all the buffers of chain. It can
+ * be invoked in interrupt handle with SMC_PBUF_NO_WAIT.
+ *
+ * @param pool     [the pool]
+ * @param len      [the data length]
+ * @param headroom [the bytes reserved before data, less than buffer size]
+ * @param time_out [the waiting time for free buffers]
+ *
+ * @return         [the chain, NULL on timeout or invalid argument]
+ */
+smc_pbuf_t *smc_pbuf_alloc(smc_pbuf_pool_t *pool,
+                           smc_uint16_t len,
+                           smc_uint16_t headroom,
+                           smc_int32_t time_out)
+{
+	smc_uint32_t first = pool->buf_size - headroom;
+	smc_uint32_t start = smc_tick_get();
+	smc_uint32_t num   = 1;
+	smc_uint32_t taken;
+	smc_uint32_t rest;
+	smc_uint32_t status;
+	smc_pbuf_t *head;
+	smc_pbuf_t *p;
+
+	if (headroom >= pool->buf_size)
+		return NULL;
+
+	if (len > first)
+		num += (len - first + pool->buf_size - 1) / pool->buf_size;
+	if (num > pool->num)
+		return NULL;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	/**
+	 * All the buffers are taken at once, a waiting thread never holds a
+	 * part of them, so two waiters can't block each other forever.
+	 */
+	while (pool->avail < num) {
+		smc_int32_t remaining = time_out;
+
+		if (time_out > 0) {
+			remaining = time_out - (smc_int32_t)(smc_tick_get() - start);
+			if (remaining < 0)
+				remaining = SMC_PBUF_NO_WAIT;
+		}
+
+		if (remaining == SMC_PBUF_NO_WAIT) {
+			smc_cpu_enable_interrupt(status);
+			return NULL;
+		}
+
+		/* suspend the current thread to pool wait queue */
+		smc_waitq_suspend(&pool->waitq, remaining);
+
+		smc_scheduler();
+
+		/* enable interrupt, and will make contex switch */
+		smc_cpu_enable_interrupt(status);
+
+		if (smc_thread_current->error_num != SMC_OK)
+			return NULL;
+
+		/* disable interrupt */
+		status = smc_cpu_disable_interrupt();
+	}
+
+	pool->avail -= num;
+	head = pool->free;
+	for (p = head, taken = 1; taken < num; taken++)
+		p = p->next;
+	pool->free = p->next;
+	p->next    = NULL;
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	rest = len;
+	for (p = head; p; p = p->next) {
+		smc_uint32_t room = p == head ? first : pool->buf_size;
+
+		p->payload = smc_pbuf_data(p) + pool->buf_size - room;
+		p->len     = rest < room ? rest : room;
+		p->tot_len = rest;
+		p->ref     = 1;
+		rest      -= p->len;
+	}
+
+	return head;
+}
+
+/**
+ * This function will add a reference to chain, so one more consumer can
+ * hold it. It can be invoked in interrupt handle.
+ *
+ * @param p [the chain]
+ */
+void smc_pbuf_ref(smc_pbuf_t *p)
+{
+	smc_atomic_add(&p->ref, 1);
+}
+
+/**
+ * This function will drop a reference of chain. The buffers whose reference
+ * count reaches zero are returned to their pools. It can be invoked in
+ * interrupt handle.
+ *
+ * @param p [the chain]
+ *
+ * @return  [how many buffers are freed]
+ */
+smc_uint32_t smc_pbuf_free(smc_pbuf_t *p)
+{
+	smc_uint32_t count = 0;
+
+	while (p) {
+		smc_pbuf_t *next = p->next;
+
+		/* the rest of chain is still held by the other reference */
+		if (smc_atomic_add(&p->ref, (smc_uint32_t)-1) != 0U)
+			break;
+
+		smc_pbuf_pool_put(p);
+		count++;
+		p = next;
+	}
+
+	return count;
+}
+
+/**
+ * This function will move the payload of the first buffer, a positive
+ * delta prepends a header in headroom and a negative one hides a header.
+ * A shared buffer should not be changed.
+ *
+ * @param p     [the chain]
+ * @param delta [the bytes to move]
+ *
+ * @return      [SMC_OK on success, -SMC_ERROR if out of buffer]
+ */
+smc_int32_t smc_pbuf_header(smc_pbuf_t *p, smc_int16_t delta)
+{
+	if (delta > 0) {
+		if (p->payload - smc_pbuf_data(p) < delta ||
+		    p->tot_len + delta > 0xFFFF)
+			return -SMC_ERROR;
+	} else {
+		if (p->len < -delta)
+			return -SMC_ERROR;
+	}
+
+	p->payload -= delta;
+	p->len     += delta;
+	p->tot_len += delta;
+
+	return SMC_OK;
+}
+
+/**
+ * This function will append a chain to another, the reference of tail is
+ * taken over by head.
+ *
+ * @param head [the chain]
+ * @param tail [the chain appended]
+ *
+ * @return     [SMC_OK on success, -SMC_ERROR if the length overflows]
+ */
+smc_int32_t smc_pbuf_cat(smc_pbuf_t *head, smc_pbuf_t *tail)
+{
+	smc_pbuf_t *p;
+
+	if (head->tot_len + tail->tot_len > 0xFFFF)
+		return -SMC_ERROR;
+
+	for (p = head; p->next; p = p->next)
+		p->tot_len += tail->tot_len;
+	p->tot_len += tail->tot_len;
+	p->next     = tail;
+
+	return SMC_OK;
+}
+
+/**
+ * This function will find the buffer holding an offset of chain
+ *
+ * @param p      [the chain]
+ * @param offset [the offset in chain, it's changed to the offset in buffer]
+ *
+ * @return       [the buffer, NULL if offset is out of chain]
+ */
+static smc_pbuf_t *smc_pbuf_skip(smc_pbuf_t *p, smc_uint32_t *offset)
+{
+	while (p && *offset >= p->len) {
+		*offset -= p->len;
+		p        = p->next;
+	}
+
+	return p;
+}
+
+/**
+ * This function will copy bytes into chain
+ *
+ * @param p      [the chain]
+ * @param data   [the bytes]
+ * @param len    [the number of bytes]
+ * @param offset [the offset in chain]
+ *
+ * @return       [how many bytes are copied]
+ */
+smc_uint32_t smc_pbuf_copy_in(smc_pbuf_t *p,
+                              const void *data,
+                              smc_uint32_t len,
+                              smc_uint32_t offset)
+{
+	const smc_uint8_t *bytes = (const smc_uint8_t *)data;
+	smc_uint32_t copied = 0;
+
+	for (p = smc_pbuf_skip(p, &offset); p && copied < len; p = p->next) {
+		smc_uint32_t n = p->len - offset;
+
+		if (n > len - copied)
+			n = len - copied;
+		memcpy(p->payload + offset, bytes + copied, n);
+		copied += n;
+		offset  = 0;
+	}
+
+	return copied;
+}
+
+/**
+ * This function will copy bytes out of chain
+ *
+ * @param p      [the chain]
+ * @param data   [the buffer of bytes]
+ * @param len    [the size of buffer]
+ * @param offset [the offset in chain]
+ *
+ * @return       [how many bytes are copied]
+ */
+smc_uint32_t smc_pbuf_copy_out(smc_pbuf_t *p,
+                               void *data,
+                               smc_uint32_t len,
+                               smc_uint32_t offset)
+{
+	smc_uint8_t *bytes = (smc_uint8_t *)data;
+	smc_uint32_t copied = 0;
+
+	for (p = smc_pbuf_skip(p, &offset); p && copied < len; p = p->next) {
+		smc_uint32_t n = p->len - offset;
+
+		if (n > len - copied)
+			n = len - copied;
+		memcpy(bytes + copied, p->payload + offset, n);
+		copied += n;
+		offset  = 0;
+	}
+
+	return copied;
+}
+
+/**
+ * This function will initialize a queue passing chains between threads
+ *
+ * @param queue [the queue]
+ * @param slot  [the array of slots]
+ * @param size  [how many slots]
+ */
+void smc_pbuf_queue_init(smc_pbuf_queue_t *queue,
+                         smc_pbuf_t **slot,
+                         smc_uint16_t size)
+{
+	queue->slot = slot;
+	queue->size = size;
+	queue->head = 0;
+	queue->tail = 0;
+	smc_sem_init(&queue->slots, size);
+	smc_sem_init(&queue->items, 0);
+}
+
+/**
+ * This function will post a chain to queue, the reference of caller is
+ * passed to the receiver. Post to several queues after smc_pbuf_ref() to
+ * share a chain. It can be invoked in interrupt handle with
+ * SMC_PBUF_NO_WAIT.
+ *
+ * @param queue    [the queue]
+ * @param p        [the chain]
+ * @param time_out [the waiting time for a free slot]
+ *
+ * @return         [error number]
+ */
+smc_int32_t smc_pbuf_queue_post(smc_pbuf_queue_t *queue,
+                                smc_pbuf_t *p,
+                                smc_int32_t time_out)
+{
+	smc_int32_t error_num = smc_sem_pend(&queue->slots, time_out);
+	smc_uint32_t status;
+
+	if (error_num != SMC_OK)
+		return error_num;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	queue->slot[queue->tail] = p;
+	if (++queue->tail == queue->size)
+		queue->tail = 0;
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	return smc_sem_release(&queue->items);
+}
+
+/**
+ * This function will fetch a chain from queue, the receiver owns a
+ * reference and frees it when done.
+ *
+ * @param queue    [the queue]
+ * @param time_out [the waiting time for a chain]
+ *
+ * @return         [the chain, NULL on timeout]
+ */
+smc_pbuf_t *smc_pbuf_queue_fetch(smc_pbuf_queue_t *queue, smc_int32_t time_out)
+{
+	smc_pbuf_t *p;
+	smc_uint32_t status;
+
+	if (smc_sem_pend(&queue->items, time_out) != SMC_OK)
+		return NULL;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	p = queue->slot[queue->head];
+	if (++queue->head == queue->size)
+		queue->head = 0;
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	smc_sem_release(&queue->slots);
+
+	return p;
+}
+
+#endif /* SMC_USING_PBUF */
@@ -0,0 +1,305 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-31
+ * Describe: This is a part of SMC-RTOS for idle power governor, it chooses
+ *           the idle state by the predicted idle time and latency constraint.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_pm.h"
+#include "smc_list.h"
+#include "smc_core.h"
+#include "smc_cpu.h"
+#include "smc_timer.h"
+
+#ifdef SMC_USING_PM
+
+#define SMC_PM_CORRECTION_ONE   1024U                              /* correction factor 1.0 */
+
+static smc_uint32_t smc_pm_spin_enter(smc_uint32_t sleep_us);
+static smc_uint32_t smc_pm_wfi_enter(smc_uint32_t sleep_us);
+
+static smc_pm_state_t smc_pm_spin = {
+	smc_pm_spin_enter, 0, 0, 0,
+	0, 0, 0, 0
+};
+
+static smc_pm_state_t smc_pm_wfi = {
+	smc_pm_wfi_enter, SMC_PM_WFI_LATENCY_US, 0, 0,
+	0, 0, 0, 0
+};
+
+static smc_pm_state_t *smc_pm_states[SMC_PM_STATE_MAX] = {
+	&smc_pm_spin, &smc_pm_wfi
+};
+static smc_uint8_t smc_pm_state_count = 2;
+
+static smc_list_head_t smc_pm_qos_list =
+	LIST_NODE_INIT(smc_pm_qos_list);                      /* wakeup latency constraint list */
+
+/* the ratio of measured to predicted idle time in recent history */
+static smc_uint32_t smc_pm_correction = SMC_PM_CORRECTION_ONE;
+static smc_uint32_t smc_pm_tick_remainder;                    /* slept microseconds less than a tick */
+
+/**
+ * The spin state, the idle thread loops again.
+ */
+static smc_uint32_t smc_pm_spin_enter(smc_uint32_t sleep_us)
+{
+	return 0;
+}
+
+/**
+ * The WFI state, the tick keeps running and wakes the cpu up.
+ */
+static smc_uint32_t smc_pm_wfi_enter(smc_uint32_t sleep_us)
+{
+	smc_cpu_wait_for_interrupt();
+
+	return 0;
+}
+
+/**
+ * This function will register a deep idle state, the states should be
+ * registered from shallow to deep.
+ *
+ * @param state [the idle state]
+ *
+ * @return      [the index of state, -SMC_NOMEM if it's full]
+ *
+ * @note        [if the state stops the tick, the enter function should]
+ * wake up after sleep_us at most and return the slept microseconds until it
+ * returns. The time beyond sleep_us is the wake latency of the state.
+ */
+smc_int32_t smc_pm_state_register(smc_pm_state_t *state)
+{
+	smc_uint32_t status;
+	smc_int32_t index = -SMC_NOMEM;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	if (smc_pm_state_count < SMC_PM_STATE_MAX) {
+		state->entries             = 0;
+		state->residency_us        = 0;
+		state->residency_max_us    = 0;
+		state->wake_latency_max_us = 0;
+
+		index = smc_pm_state_count++;
+		smc_pm_states[index] = state;
+	}
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	return index;
+}
+
+/**
+ * This function will return an idle state for its statistics
+ *
+ * @param index [the index of state]
+ *
+ * @return      [the idle state, NULL if it doesn't exist]
+ */
+smc_pm_state_t *smc_pm_state_get(smc_uint8_t index)
+{
+	return index < smc_pm_state_count ? smc_pm_states[index] : NULL;
+}
+
+/**
+ * This function will add a wakeup latency constraint
+ *
+ * @param qos        [the constraint]
+ * @param latency_us [the max tolerable wakeup latency]
+ */
+void smc_pm_qos_add(smc_pm_qos_t *qos, smc_uint32_t latency_us)
+{
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	qos->latency_us = latency_us;
+	smc_list_add_tail(&qos->qlist, &smc_pm_qos_list);
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+}
+
+/**
+ * This function will update a wakeup latency constraint
+ *
+ * @param qos        [the constraint]
+ * @param latency_us [the max tolerable wakeup latency]
+ */
+void smc_pm_qos_update(smc_pm_qos_t *qos, smc_uint32_t latency_us)
+{
+	qos->latency_us = latency_us;
+}
+
+/**
+ * This function will remove a wakeup latency constraint
+ *
+ * @param qos [the constraint]
+ */
+void smc_pm_qos_remove(smc_pm_qos_t *qos)
+{
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	smc_list_del_entry(&qos->qlist);
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+}
+
+/**
+ * This function will return the strictest latency constraint
+ *
+ * @return [the min tolerable wakeup latency]
+ *
+ * @note   [it must be invoked with interrupt disabled]
+ */
+static smc_uint32_t smc_pm_qos_latency(void)
+{
+	smc_list_node_t *pos;
+	smc_uint32_t latency = 0xFFFFFFFFU;
+
+	for (pos = smc_pm_qos_list.next; pos != &smc_pm_qos_list; pos = pos->next) {
+		smc_pm_qos_t *qos = smc_list_entry(pos, smc_pm_qos_t, qlist);
+
+		if (qos->latency_us < latency)
+			latency = qos->latency_us;
+	}
+
+	return latency;
+}
+
+/**
+ * This function will make up the ticks lost while the tick is stopped
+ *
+ * @param slept_us [the slept microseconds]
+ *
+ * @note           [it must be invoked with interrupt disabled]
+ */
+static void smc_pm_tick_compensate(smc_uint32_t slept_us)
+{
+	smc_uint32_t ticks;
+
+	smc_pm_tick_remainder += slept_us;
+	ticks = smc_pm_tick_remainder / SMC_US_PER_TICK;
+	smc_pm_tick_remainder %= SMC_US_PER_TICK;
+
+	/* the expired timers are processed, and reschedule only once */
+	smc_enter_interrupt();
+	while (ticks--)
+		smc_time_tick();
+	smc_exit_interrupt();
+}
+
+/**
+ * This function will choose an idle state and enter it, it's invoked by
+ * idle thread loop.
+ */
+void smc_pm_idle(void)
+{
+	smc_pm_state_t *state = &smc_pm_spin;
+	smc_uint32_t cycles_per_us = smc_cpu_cycles_per_us();
+	smc_uint32_t latency, next_tick_us, next_timer_us, predict_us = 0;
+	smc_uint32_t tick, tick_cycle, start, idle_us, slept_us, wake_us;
+	smc_uint32_t status;
+	smc_int8_t i;
+
+	/**
+	 * disable interrupt, the parenthesized name isn't profiled, otherwise
+	 * the sleep is reported as the longest interrupt disabled time.
+	 */
+	status = (smc_cpu_disable_interrupt)();
+
+	latency = smc_pm_qos_latency();
+	tick    = smc_tick_get_stamp(&tick_cycle);
+	start   = smc_cpu_cycle_get();
+
+	/* the tick wakes up the shallow states, the next timer the tickless */
+	idle_us      = (start - tick_cycle) / cycles_per_us;
+	next_tick_us = idle_us < SMC_US_PER_TICK ? SMC_US_PER_TICK - idle_us : 0;
+
+	next_timer_us = smc_timer_next_timeout();
+	if (next_timer_us == 0U)
+		next_timer_us = next_tick_us;
+	else if (next_timer_us > 0xFFFFFFFFU / SMC_US_PER_TICK)
+		next_timer_us = 0xFFFFFFFFU;
+	else
+		next_timer_us = next_timer_us * SMC_US_PER_TICK - (SMC_US_PER_TICK - next_tick_us);
+
+	/* the deepest state fits the predicted idle time and the constraint */
+	for (i = smc_pm_state_count - 1; i >= 0; i--) {
+		smc_pm_state_t *s = smc_pm_states[i];
+		smc_uint32_t raw  = s->stop_tick ? next_timer_us : next_tick_us;
+		smc_uint32_t predict;
+
+		if (s->exit_latency_us > latency)
+			continue;
+
+		/* the recent history corrects the prediction of early wakeup */
+		predict = (raw / SMC_PM_CORRECTION_ONE) * smc_pm_correction +
+		          (raw % SMC_PM_CORRECTION_ONE) * smc_pm_correction / SMC_PM_CORRECTION_ONE;
+		if (s->target_residency_us <= predict) {
+			state      = s;
+			predict_us = raw;
+			break;
+		}
+	}
+
+	slept_us = state->enter(state->stop_tick ? predict_us : 0);
+
+	if (state == &smc_pm_spin) {
+		(smc_cpu_enable_interrupt)(status);
+		return;
+	}
+
+	/* the cycle counter may stop in the tickless state */
+	idle_us = slept_us ? slept_us : (smc_cpu_cycle_get() - start) / cycles_per_us;
+
+	if (state->stop_tick) {
+		smc_pm_tick_compensate(slept_us);
+
+		/* woken by its wakeup timer, the overshoot is the wake latency */
+		if (slept_us >= predict_us) {
+			wake_us = slept_us - predict_us;
+			if (wake_us > state->wake_latency_max_us)
+				state->wake_latency_max_us = wake_us;
+		}
+	}
+
+	/* update the ratio of measured to predicted idle time */
+	if (predict_us > 0U) {
+		smc_uint32_t ratio = idle_us >= predict_us ? SMC_PM_CORRECTION_ONE :
+		                     (smc_uint32_t)((smc_uint64_t)idle_us * SMC_PM_CORRECTION_ONE / predict_us);
+
+		smc_pm_correction = smc_pm_correction - smc_pm_correction / 8U + ratio / 8U;
+	}
+
+	state->entries++;
+	state->residency_us += idle_us;
+	if (idle_us > state->residency_max_us)
+		state->residency_max_us = idle_us;
+
+	/* enable interrupt, the pending interrupt which waked cpu runs */
+	(smc_cpu_enable_interrupt)(status);
+
+	/* woken by the tick, measure from its interrupt to here */
+	if (!state->stop_tick && smc_tick_get_stamp(&tick_cycle) != tick) {
+		wake_us = (smc_cpu_cycle_get() - tick_cycle) / cycles_per_us;
+
+		if (wake_us > state->wake_latency_max_us)
+			state->wake_latency_max_us = wake_us;
+	}
+}
+
+#endif /* SMC_USING_PM */
@@ -0,0 +1,298 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-17
+ * Describe: This is a part of SMC-RTOS for reader-writer lock
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_rwlock.h"
+#include "smc_list.h"
+#include "smc_thread.h"
+#include "smc_core.h"
+#include "smc_waitq.h"
+#include "smc_lockstat.h"
+
+#ifdef SMC_USING_RWLOCK
+/**
+ * This function will initialize a reader-writer lock
+ *
+ * @param lock [the reader-writer lock]
+ */
+void smc_rwlock_init(smc_rwlock_t *lock)
+{
+	smc_waitq_init(&lock->rwaitq, SMC_WAITQ_FIFO);
+	smc_waitq_init(&lock->wwaitq, SMC_WAITQ_PRIO);
+	lock->writer  = NULL;
+	lock->readers = 0;
+	smc_list_node_init(&lock->hlist);
+#ifdef SMC_USING_LOCK_STATS
+	smc_lockstat_init(&lock->stats);
+#endif
+}
+
+/**
+ * This function will return the highest priority of the threads waiting
+ * for the lock
+ *
+ * @param lock [the reader-writer lock]
+ *
+ * @return     [the priority, SMC_PRIORITY_MAX if no thread is waiting]
+ */
+static smc_uint8_t smc_rwlock_waiter_priority(smc_rwlock_t *lock)
+{
+	smc_uint8_t priority = SMC_PRIORITY_MAX;
+	smc_thread_t *thread;
+
+	/* the writers are in priority order, but the readers are FIFO */
+	thread = smc_waitq_first(&lock->wwaitq);
+	if (thread)
+		priority = thread->priority;
+	smc_list_for_each_entry(thread, smc_thread_t, &lock->rwaitq.wlist, rlist) {
+		if (thread->priority < priority)
+			priority = thread->priority;
+	}
+
+	return priority;
+}
+
+/**
+ * This function will set the priority of writer to the highest one of its
+ * init priority and the threads waiting for all the locks it holds.
+ *
+ * @param writer [the thread holding locks for writing]
+ *
+ * @note         [it must be invoked with interrupt disabled]
+ */
+static void smc_rwlock_inherit(smc_thread_t *writer)
+{
+	smc_uint8_t priority = writer->init_priority;
+	smc_uint8_t waiter;
+	smc_rwlock_t *lock;
+
+	smc_list_for_each_entry(lock, smc_rwlock_t, &writer->rwlock_list, hlist) {
+		waiter = smc_rwlock_waiter_priority(lock);
+		if (waiter < priority)
+			priority = waiter;
+	}
+
+	if (writer->priority != priority)
+		smc_thread_set_priority(writer, priority);
+}
+
+/**
+ * This function will give the lock to a writer
+ *
+ * @param lock   [the reader-writer lock]
+ * @param writer [the thread taking the lock for writing]
+ *
+ * @note         [it must be invoked with interrupt disabled]
+ */
+static void smc_rwlock_set_writer(smc_rwlock_t *lock, smc_thread_t *writer)
+{
+	lock->writer = writer;
+	smc_list_add_tail(&lock->hlist, &writer->rwlock_list);
+}
+
+/**
+ * This function will hand over the lock to all the waiting readers
+ *
+ * @param lock [the reader-writer lock]
+ *
+ * @note       [it must be invoked with interrupt disabled, and then]
+ * smc_scheduler() must be invoked.
+ */
+static void smc_rwlock_wake_readers(smc_rwlock_t *lock)
+{
+	smc_thread_t *thread;
+
+	while ((thread = smc_waitq_first(&lock->rwaitq)) != NULL) {
+		lock->readers++;
+		smc_thread_wakeup(thread);
+	}
+}
+
+/**
+ * This function will suspend the current thread to the wait queue of lock,
+ * and the writer holding the lock inherits the priority of current thread.
+ * The lock is handed over to the thread when it's waked, and the inherited
+ * priority is given back if it times out.
+ *
+ * @param lock     [the reader-writer lock]
+ * @param waitq    [the wait queue of lock]
+ * @param time_out [the waiting time]
+ * @param status   [the interrupt status before disable]
+ *
+ * @return         [error number]
+ */
+static smc_int32_t smc_rwlock_suspend(smc_rwlock_t *lock,
+                                      smc_waitq_t *waitq,
+                                      smc_int32_t time_out,
+                                      smc_uint32_t status)
+{
+#ifdef SMC_USING_LOCK_STATS
+	smc_uint32_t stamp = smc_lockstat_contend(&lock->stats);
+#endif
+
+	if (time_out == SMC_RWLOCK_NO_WAIT) {
+		smc_cpu_enable_interrupt(status);
+#ifdef SMC_USING_LOCK_STATS
+		smc_lockstat_wait_done(&lock->stats, stamp, -SMC_TIMEOUT);
+#endif
+		return -SMC_TIMEOUT;
+	}
+
+	smc_waitq_suspend(waitq, time_out);
+
+	/* priority inheritance, the readers holding lock can't be boosted */
+	if (lock->writer)
+		smc_rwlock_inherit(lock->writer);
+
+	smc_scheduler();
+
+	/* enable interrupt, and will make contex switch */
+	smc_cpu_enable_interrupt(status);
+
+	/* the boost for this thread isn't owed any more */
+	if (smc_thread_current->error_num != SMC_OK) {
+		status = smc_cpu_disable_interrupt();
+		if (lock->writer) {
+			smc_rwlock_inherit(lock->writer);
+		} else if (smc_waitq_first(&lock->wwaitq) == NULL &&
+		           smc_waitq_first(&lock->rwaitq) != NULL) {
+			/* the readers blocked by the writer timed out join the holders */
+			smc_rwlock_wake_readers(lock);
+			smc_scheduler();
+		}
+		smc_cpu_enable_interrupt(status);
+	}
+
+#ifdef SMC_USING_LOCK_STATS
+	smc_lockstat_wait_done(&lock->stats, stamp, smc_thread_current->error_num);
+#endif
+	return smc_thread_current->error_num;
+}
+
+/**
+ * This function will take the lock for reading. Many readers can hold the
+ * lock at the same time, but a reader will wait if a writer holds or waits
+ * for the lock.
+ *
+ * @param lock     [the reader-writer lock]
+ * @param time_out [the waiting time]
+ *
+ * @return         [error number]
+ */
+smc_int32_t smc_rwlock_read_lock(smc_rwlock_t *lock, smc_int32_t time_out)
+{
+	smc_uint32_t status;
+
+#ifdef SMC_USING_LOCK_STATS
+	smc_lockstat_pend(&lock->stats);
+#endif
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	/* writer preferring, the waiting writer blocks new readers */
+	if (lock->writer == NULL && smc_waitq_first(&lock->wwaitq) == NULL) {
+		lock->readers++;
+
+		/* enable interrupt */
+		smc_cpu_enable_interrupt(status);
+
+		return SMC_OK;
+	}
+
+	return smc_rwlock_suspend(lock, &lock->rwaitq, time_out, status);
+}
+
+/**
+ * This function will take the lock for writing exclusively. The writer
+ * holding the lock inherits the priority of the threads waiting for it.
+ *
+ * @param lock     [the reader-writer lock]
+ * @param time_out [the waiting time]
+ *
+ * @return         [error number]
+ *
+ * @note [the inheritance is one level only, if the boosted writer waits]
+ * for another lock or semaphore, it keeps its place in that wait queue and
+ * the holder there isn't boosted.
+ */
+smc_int32_t smc_rwlock_write_lock(smc_rwlock_t *lock, smc_int32_t time_out)
+{
+	smc_uint32_t status;
+
+#ifdef SMC_USING_LOCK_STATS
+	smc_lockstat_pend(&lock->stats);
+#endif
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	if (lock->writer == NULL && lock->readers == 0U) {
+		smc_rwlock_set_writer(lock, smc_thread_current);
+
+		/* enable interrupt */
+		smc_cpu_enable_interrupt(status);
+
+		return SMC_OK;
+	}
+
+	return smc_rwlock_suspend(lock, &lock->wwaitq, time_out, status);
+}
+
+/**
+ * This function will release the lock held by the current thread for reading
+ * or writing. The waiting writer is waked first, otherwise all the waiting
+ * readers are waked.
+ *
+ * @param lock [the reader-writer lock]
+ *
+ * @return     [error number]
+ */
+smc_int32_t smc_rwlock_unlock(smc_rwlock_t *lock)
+{
+	smc_thread_t *thread;
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	if (lock->writer == smc_thread_current) {
+		lock->writer = NULL;
+		smc_list_del_entry(&lock->hlist);
+
+		/* keep the priority inherited by the other locks held */
+		smc_rwlock_inherit(smc_thread_current);
+	} else if (lock->readers > 0U) {
+		lock->readers--;
+	} else {
+		smc_cpu_enable_interrupt(status);
+		return -SMC_ERROR;
+	}
+
+	if (lock->writer == NULL && lock->readers == 0U) {
+		thread = smc_waitq_first(&lock->wwaitq);
+		if (thread) {
+			/* hand over the lock to the first writer, it inherits the rest */
+			smc_thread_wakeup(thread);
+			smc_rwlock_set_writer(lock, thread);
+			smc_rwlock_inherit(thread);
+			smc_scheduler();
+		} else {
+			/* hand over the lock to all the readers, and schedule once */
+			smc_rwlock_wake_readers(lock);
+			smc_scheduler();
+		}
+	}
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	return SMC_OK;
+}
+
+#endif /* SMC_USING_RWLOCK */
@@ -12,18 +12,81 @@
 #include "smc_thread.h"
 #include "smc_core.h"
 #include "smc_timer.h"
+#include "smc_waitq.h"
+#include "smc_atomic.h"
+#include "smc_waitset.h"
+#include "smc_lockstat.h"
 
 #ifdef SMC_USING_SEMAPHORE
 /**
- * This function will initialize a semaphore
+ * This function will return whether any thread or wait set is waiting for
+ * the semaphore, it may be a false positive.
+ *
+ * @param sem [the semaphore]
+ *
+ * @return    [1 on waited, 0 on not]
+ */
+smc_inline smc_bool_t smc_sem_is_waited(smc_sem_t *sem)
+{
+#ifdef SMC_USING_WAITSET
+	if (!smc_list_is_empty(&sem->plist))
+		return 1;
+#endif
+	return *(smc_list_node_t * volatile *)&sem->waitq.wlist.next != &sem->waitq.wlist;
+}
+
+/**
+ * This function will initialize a semaphore, the suspended threads are
+ * waked in priority order.
  *
  * @param sem   [the semaphore]
  * @param value [the init value of semaphore]
  */
 void smc_sem_init(smc_sem_t *sem, smc_uint16_t value)
 {
-	smc_list_node_init(&sem->slist);
+	smc_sem_init_policy(sem, value, SMC_WAITQ_PRIO);
+}
+
+/**
+ * This function will initialize a semaphore with a wait queue policy
+ *
+ * @param sem    [the semaphore]
+ * @param value  [the init value of semaphore]
+ * @param policy [the wait queue policy of the suspended threads]
+ */
+void smc_sem_init_policy(smc_sem_t *sem, smc_uint16_t value, smc_uint8_t policy)
+{
+	smc_waitq_init(&sem->waitq, policy);
 	sem->value = value;
+#ifdef SMC_USING_WAITSET
+	smc_list_node_init(&sem->plist);
+#endif
+#ifdef SMC_USING_LOCK_STATS
+	smc_lockstat_init(&sem->stats);
+#endif
+}
+
+/**
+ * This function will take a semaphore if it's available without waiting.
+ * It's the probe of wait set and coroutine, so it isn't counted by lock
+ * statistics. It can be invoked in interrupt handle.
+ *
+ * @param sem [the semaphore]
+ *
+ * @return    [SMC_OK on success, -SMC_TIMEOUT if it's unavailable]
+ */
+smc_int32_t smc_sem_try_take(smc_sem_t *sem)
+{
+	smc_uint32_t value;
+
+	/* take the semaphore without disabling interrupt */
+	while ((value = smc_atomic_load_ex(&sem->value)) > 0U) {
+		if (smc_atomic_store_ex(&sem->value, value - 1) == 0U)
+			return SMC_OK;
+	}
+	smc_atomic_clear_ex();
+
+	return -SMC_TIMEOUT;
 }
 
 /**
@@ -38,6 +101,15 @@ void smc_sem_init(smc_sem_t *sem, smc_uint16_t value)
 smc_int32_t smc_sem_pend(smc_sem_t *sem, smc_int32_t time_out)
 {
 	smc_uint32_t status;
+#ifdef SMC_USING_LOCK_STATS
+	smc_uint32_t stamp;
+
+	smc_lockstat_pend(&sem->stats);
+#endif
+
+	/* fast path: take the semaphore without disabling interrupt */
+	if (smc_sem_try_take(sem) == SMC_OK)
+		return SMC_OK;
 
 	/* disable interrupt */
 	status = smc_cpu_disable_interrupt();
@@ -48,41 +120,28 @@ smc_int32_t smc_sem_pend(smc_sem_t *sem, smc_int32_t time_out)
 		/* enable interrupt */
 		smc_cpu_enable_interrupt(status);
 	} else {
+#ifdef SMC_USING_LOCK_STATS
+		stamp = smc_lockstat_contend(&sem->stats);
+#endif
 		if (time_out == SMC_SEM_NO_WAIT) {
 			smc_cpu_enable_interrupt(status);
+#ifdef SMC_USING_LOCK_STATS
+			smc_lockstat_wait_done(&sem->stats, stamp, -SMC_TIMEOUT);
+#endif
 			return -SMC_TIMEOUT;
 		} else {
-			/* reset thread error number */
-			smc_thread_current->error_num = SMC_OK;
-
-			/* suspend the current thread and do schedule */
-			smc_thread_suspend(smc_thread_current);
-
-			if (time_out != SMC_SEM_WAIT_FOREVER) {
-				smc_uint8_t flag = SMC_TIMER_ONCE;
-
-				/* set timer timeout tick */
-				smc_timer_command(&smc_thread_current->timer,
-				                  SMC_TIMER_SET_TIMEOUT_TICK_IMMEDIATELY,
-				                  &time_out);
-
-				/* set timer flag */
-				smc_timer_command(&smc_thread_current->timer,
-				                  SMC_TIMER_SET_OPERATION_MODE,
-				                  &flag);
-
-				/* timer startup */
-				smc_timer_enable(&smc_thread_current->timer);
-			}
-
-			/* add the current thread to semaphore list */
-			smc_list_add(&smc_thread_current->rlist, &sem->slist);
+			/* suspend the current thread to semaphore wait queue */
+			smc_waitq_suspend(&sem->waitq, time_out);
 
 			smc_scheduler();
 
 			/* enable interrupt, and will make contex switch */
 			smc_cpu_enable_interrupt(status);
 
+#ifdef SMC_USING_LOCK_STATS
+			smc_lockstat_wait_done(&sem->stats, stamp,
+			                       smc_thread_current->error_num);
+#endif
 			if (smc_thread_current->error_num != SMC_OK)
 				return smc_thread_current->error_num;
 		}
@@ -101,23 +160,38 @@ smc_int32_t smc_sem_pend(smc_sem_t *sem, smc_int32_t time_out)
  */
 smc_int32_t smc_sem_release(smc_sem_t *sem)
 {
+	smc_thread_t *thread;
 	smc_uint32_t status;
+	smc_uint32_t value;
+
+	/* fast path: no thread is waiting, just increase the value */
+	while (1) {
+		value = smc_atomic_load_ex(&sem->value);
+		if (smc_sem_is_waited(sem)) {
+			smc_atomic_clear_ex();
+			break;
+		}
+		if (smc_atomic_store_ex(&sem->value, value + 1) == 0U)
+			return SMC_OK;
+	}
 
 	/* disable interrupt */
 	status = smc_cpu_disable_interrupt();
 
-	if (!smc_list_is_empty(&sem->slist)) {
-		smc_thread_t *thread;
-
-		thread = smc_list_entry(sem->slist.next, smc_thread_t, rlist);
-
+	thread = smc_waitq_first(&sem->waitq);
+	if (thread) {
 		/**
-		 * resume the first thread in the pending thread list waiting for
-		 * the special semaphore.
+		 * resume the first thread in the wait queue waiting for the
+		 * special semaphore.
 		 */
 		smc_thread_resume(thread);
 	} else {
 		sem->value++;
+#ifdef SMC_USING_WAITSET
+		/* wake up the wait sets polling the semaphore */
+		if (smc_poll_notify(&sem->plist))
+			smc_scheduler();
+#endif
 	}
 
 	/* enable interrupt */
@@ -0,0 +1,136 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-29
+ * Describe: This is a part of SMC-RTOS for run-to-completion task, tasks
+ *           share the main stack and preempt each other by nested call.
+ *           Each task priority has its own software interrupt, so a task
+ *           only runs above the tasks and threads of lower priority.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_sst.h"
+#include "smc_core.h"
+#include "smc_cpu.h"
+
+#ifdef SMC_USING_SST
+
+static smc_sst_task_t *smc_sst_table[SMC_SST_PRIORITY_MAX];
+
+/**
+ * This function will initialize a run-to-completion task. The task runs
+ * above all threads, and its handler must never block.
+ *
+ * @param task     [the task]
+ * @param handler  [the function will be invoked for each event]
+ * @param priority [the unique priority of task, 0 is the highest]
+ * @param queue    [the event queue buffer]
+ * @param size     [the event queue size]
+ *
+ * @return         [SMC_OK on success, -SMC_BUSY if the priority is used]
+ */
+smc_int32_t smc_sst_task_init(smc_sst_task_t *task,
+                              void (*handler)(smc_sst_task_t *task, void *event),
+                              smc_uint8_t priority,
+                              void **queue,
+                              smc_uint8_t size)
+{
+	if (priority >= SMC_SST_PRIORITY_MAX || smc_sst_table[priority])
+		return -SMC_BUSY;
+
+	task->handler  = handler;
+	task->queue    = queue;
+	task->size     = size;
+	task->head     = 0;
+	task->count    = 0;
+	task->priority = priority;
+
+	smc_sst_table[priority] = task;
+	smc_hw_sst_enable(priority);
+
+	return SMC_OK;
+}
+
+/**
+ * This function will post an event to a task. It can be invoked in thread,
+ * task and interrupt handle. The software interrupt of task is pended, so
+ * the task preempts the caller at once if it has higher priority, otherwise
+ * it runs when the caller returns.
+ *
+ * @param task  [the task]
+ * @param event [the event]
+ *
+ * @return      [SMC_OK on success, -SMC_NOMEM if the queue is full]
+ */
+smc_int32_t smc_sst_post(smc_sst_task_t *task, void *event)
+{
+	smc_uint32_t status;
+	smc_uint8_t tail;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	if (task->count == task->size) {
+		smc_cpu_enable_interrupt(status);
+		return -SMC_NOMEM;
+	}
+
+	tail = task->head + task->count;
+	if (tail >= task->size)
+		tail -= task->size;
+	task->queue[tail] = event;
+	task->count++;
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	smc_hw_sst_trigger(task->priority);
+
+	return SMC_OK;
+}
+
+/**
+ * This function should be invoked by the software interrupt handler of a
+ * task priority, which is pended by smc_hw_sst_trigger(). It dispatches
+ * all the queued events of the task, the higher tasks and interrupts can
+ * preempt it.
+ *
+ * @param priority [the task priority of the software interrupt]
+ *
+ * @note [the handler should be wrapped by smc_enter_interrupt() and]
+ * smc_exit_interrupt() as other interrupts.
+ */
+void smc_sst_isr(smc_uint8_t priority)
+{
+	smc_sst_task_t *task;
+	smc_uint32_t status;
+	void *event;
+
+	if (priority >= SMC_SST_PRIORITY_MAX || smc_sst_table[priority] == NULL)
+		return;
+	task = smc_sst_table[priority];
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	while (task->count != 0U) {
+		event = task->queue[task->head];
+		if (++task->head == task->size)
+			task->head = 0;
+		task->count--;
+
+		/* enable interrupt, higher task and interrupt can preempt it */
+		smc_cpu_enable_interrupt(status);
+
+		task->handler(task, event);
+
+		/* disable interrupt */
+		status = smc_cpu_disable_interrupt();
+	}
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+}
+
+#endif /* SMC_USING_SST */
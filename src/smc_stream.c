@@ -0,0 +1,421 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-10
+ * Describe: This is a part of SMC-RTOS for byte stream, one writer and one
+ *           reader share a ring, and the reader is waked when the trigger
+ *           level is reached.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include <string.h>
+#include "smc_stream.h"
+#include "smc_thread.h"
+#include "smc_core.h"
+#include "smc_cpu.h"
+
+#ifdef SMC_USING_STREAM
+
+#define smc_stream_used(stream)     ((stream)->tail - (stream)->head)
+#define smc_stream_free(stream)     ((stream)->size - smc_stream_used(stream))
+#define smc_stream_min(a, b)        ((a) < (b) ? (a) : (b))
+
+/**
+ * This function will wake the reader if the bytes it waits for are
+ * available, it's invoked with interrupt disabled.
+ *
+ * @param stream [the stream]
+ */
+static void smc_stream_wake_reader(smc_stream_t *stream)
+{
+	smc_thread_t *thread = stream->reader;
+
+	if (thread && smc_stream_used(stream) >= stream->reader_wanted) {
+		stream->reader = NULL;
+		smc_thread_resume(thread);
+	}
+}
+
+/**
+ * This function will wake the writer if the space it waits for is free,
+ * it's invoked with interrupt disabled.
+ *
+ * @param stream [the stream]
+ */
+static void smc_stream_wake_writer(smc_stream_t *stream)
+{
+	smc_thread_t *thread = stream->writer;
+
+	if (thread && smc_stream_free(stream) >= stream->writer_wanted) {
+		stream->writer = NULL;
+		smc_thread_resume(thread);
+	}
+}
+
+/**
+ * This function will suspend current thread on a side of stream until it's
+ * waked or time out, it's invoked with interrupt disabled and returns with
+ * interrupt enabled.
+ *
+ * @param waiter   [the waiter of the side]
+ * @param time_out [the waiting ticks]
+ * @param status   [the interrupt status to be restored]
+ *
+ * @return         [error number]
+ */
+static smc_int32_t smc_stream_suspend(smc_thread_t **waiter,
+                                      smc_int32_t time_out,
+                                      smc_uint32_t status)
+{
+	*waiter = smc_thread_current;
+	smc_thread_suspend_timeout(time_out);
+
+	smc_scheduler();
+
+	/* enable interrupt, and will make contex switch */
+	smc_cpu_enable_interrupt(status);
+
+	/* the waker clears it, but timer doesn't */
+	status  = smc_cpu_disable_interrupt();
+	*waiter = NULL;
+	smc_cpu_enable_interrupt(status);
+
+	return smc_thread_current->error_num;
+}
+
+/**
+ * This function will return the rest ticks of waiting
+ *
+ * @param time_out [the waiting time]
+ * @param start    [the tick when waiting starts]
+ *
+ * @return         [the rest ticks, 0 if time out]
+ */
+static smc_int32_t smc_stream_remaining(smc_int32_t time_out, smc_uint32_t start)
+{
+	smc_int32_t remaining;
+
+	if (time_out == SMC_STREAM_WAIT_FOREVER)
+		return SMC_STREAM_WAIT_FOREVER;
+
+	remaining = time_out - (smc_int32_t)(smc_tick_get() - start);
+
+	return remaining > 0 ? remaining : 0;
+}
+
+/**
+ * This function will initialize a stream
+ *
+ * @param stream  [the stream]
+ * @param buffer  [the ring buffer]
+ * @param size    [the size of buffer, it must be power of 2]
+ * @param trigger [how many bytes wake the reader, in [1, size]]
+ *
+ * @return        [SMC_OK on success, -SMC_ERROR if size or trigger is invalid]
+ */
+smc_int32_t smc_stream_init(smc_stream_t *stream,
+                            void *buffer,
+                            smc_uint32_t size,
+                            smc_uint32_t trigger)
+{
+	if (size == 0U || (size & (size - 1)) != 0U)
+		return -SMC_ERROR;
+	if (trigger == 0U || trigger > size)
+		return -SMC_ERROR;
+
+	stream->buffer        = (smc_uint8_t *)buffer;
+	stream->size          = size;
+	stream->head          = 0;
+	stream->tail          = 0;
+	stream->trigger       = trigger;
+	stream->reader        = NULL;
+	stream->reader_wanted = 0;
+	stream->writer        = NULL;
+	stream->writer_wanted = 0;
+
+	return SMC_OK;
+}
+
+/**
+ * This function will set the trigger level, it works since the next receive.
+ *
+ * @param stream  [the stream]
+ * @param trigger [how many bytes wake the reader, in [1, size]]
+ *
+ * @return        [SMC_OK on success, -SMC_ERROR if trigger is invalid]
+ */
+smc_int32_t smc_stream_set_trigger(smc_stream_t *stream, smc_uint32_t trigger)
+{
+	if (trigger == 0U || trigger > stream->size)
+		return -SMC_ERROR;
+
+	stream->trigger = trigger;
+
+	return SMC_OK;
+}
+
+/**
+ * This function will get the contiguous free region for writer, the bytes
+ * are filled in place and published by smc_stream_write_commit().
+ *
+ * @param stream [the stream]
+ * @param region [the start of region]
+ *
+ * @return       [the size of region, 0 if stream is full]
+ */
+smc_uint32_t smc_stream_write_peek(smc_stream_t *stream, void **region)
+{
+	smc_uint32_t offset = stream->tail & (stream->size - 1);
+
+	*region = stream->buffer + offset;
+
+	return smc_stream_min(smc_stream_free(stream), stream->size - offset);
+}
+
+/**
+ * This function will publish the bytes filled in the region of peek, and
+ * wake the reader if the trigger level is reached.
+ *
+ * @param stream [the stream]
+ * @param len    [how many bytes are filled]
+ *
+ * @return       [SMC_OK on success, -SMC_ERROR if len exceeds free space]
+ */
+smc_int32_t smc_stream_write_commit(smc_stream_t *stream, smc_uint32_t len)
+{
+	smc_uint32_t status;
+
+	if (len > smc_stream_free(stream))
+		return -SMC_ERROR;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	stream->tail += len;
+	smc_stream_wake_reader(stream);
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	return SMC_OK;
+}
+
+/**
+ * This function will get the contiguous available region for reader, the
+ * bytes are consumed in place and released by smc_stream_read_commit().
+ *
+ * @param stream [the stream]
+ * @param region [the start of region]
+ *
+ * @return       [the size of region, 0 if stream is empty]
+ */
+smc_uint32_t smc_stream_read_peek(smc_stream_t *stream, const void **region)
+{
+	smc_uint32_t offset = stream->head & (stream->size - 1);
+
+	*region = stream->buffer + offset;
+
+	return smc_stream_min(smc_stream_used(stream), stream->size - offset);
+}
+
+/**
+ * This function will release the bytes consumed in the region of peek, and
+ * wake the writer if there is enough free space.
+ *
+ * @param stream [the stream]
+ * @param len    [how many bytes are consumed]
+ *
+ * @return       [SMC_OK on success, -SMC_ERROR if len exceeds available bytes]
+ */
+smc_int32_t smc_stream_read_commit(smc_stream_t *stream, smc_uint32_t len)
+{
+	smc_uint32_t status;
+
+	if (len > smc_stream_used(stream))
+		return -SMC_ERROR;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	stream->head += len;
+	smc_stream_wake_writer(stream);
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	return SMC_OK;
+}
+
+/**
+ * This function will copy bytes into the free space, at most two regions
+ * because of wrapping. The bytes are published once.
+ *
+ * @param stream [the stream]
+ * @param data   [the bytes]
+ * @param len    [the number of bytes]
+ *
+ * @return       [how many bytes are copied]
+ */
+static smc_uint32_t smc_stream_copy_in(smc_stream_t *stream,
+                                       const smc_uint8_t *data,
+                                       smc_uint32_t len)
+{
+	smc_uint32_t offset = stream->tail & (stream->size - 1);
+	smc_uint32_t first;
+
+	len   = smc_stream_min(len, smc_stream_free(stream));
+	first = smc_stream_min(len, stream->size - offset);
+
+	memcpy(stream->buffer + offset, data, first);
+	memcpy(stream->buffer, data + first, len - first);
+
+	if (len)
+		smc_stream_write_commit(stream, len);
+
+	return len;
+}
+
+/**
+ * This function will copy bytes out of the available bytes, at most two
+ * regions because of wrapping. The space is released once.
+ *
+ * @param stream [the stream]
+ * @param data   [the buffer of bytes]
+ * @param len    [the size of buffer]
+ *
+ * @return       [how many bytes are copied]
+ */
+static smc_uint32_t smc_stream_copy_out(smc_stream_t *stream,
+                                        smc_uint8_t *data,
+                                        smc_uint32_t len)
+{
+	smc_uint32_t offset = stream->head & (stream->size - 1);
+	smc_uint32_t first;
+
+	len   = smc_stream_min(len, smc_stream_used(stream));
+	first = smc_stream_min(len, stream->size - offset);
+
+	memcpy(data, stream->buffer + offset, first);
+	memcpy(data + first, stream->buffer, len - first);
+
+	if (len)
+		smc_stream_read_commit(stream, len);
+
+	return len;
+}
+
+/**
+ * This function will copy bytes into stream. It can be invoked in interrupt
+ * handle with SMC_STREAM_NO_WAIT.
+ *
+ * @param stream   [the stream]
+ * @param data     [the bytes]
+ * @param len      [the number of bytes]
+ * @param time_out [the waiting time for free space]
+ *
+ * @return         [how many bytes are copied, less than len on timeout]
+ */
+smc_uint32_t smc_stream_send(smc_stream_t *stream,
+                             const void *data,
+                             smc_uint32_t len,
+                             smc_int32_t time_out)
+{
+	const smc_uint8_t *bytes = (const smc_uint8_t *)data;
+	smc_uint32_t start = smc_tick_get();
+	smc_uint32_t sent  = 0;
+	smc_uint32_t status;
+	smc_int32_t remaining;
+
+	while (1) {
+		sent += smc_stream_copy_in(stream, bytes + sent, len - sent);
+		if (sent == len || time_out == SMC_STREAM_NO_WAIT)
+			return sent;
+
+		remaining = smc_stream_remaining(time_out, start);
+		if (remaining == 0)
+			return sent;
+
+		/* disable interrupt */
+		status = smc_cpu_disable_interrupt();
+
+		/* the stream is full now, wait for the rest or the whole buffer */
+		stream->writer_wanted = smc_stream_min(len - sent, stream->size);
+		if (smc_stream_free(stream) >= stream->writer_wanted) {
+			smc_cpu_enable_interrupt(status);
+			continue;
+		}
+
+		if (smc_stream_suspend(&stream->writer, remaining, status) == -SMC_TIMEOUT)
+			return sent + smc_stream_copy_in(stream, bytes + sent, len - sent);
+	}
+}
+
+/**
+ * This function will copy bytes out of stream. The reader waits until the
+ * trigger level (or len if it's smaller) is reached, and then copies all
+ * the available bytes up to len. It can be invoked in interrupt handle with
+ * SMC_STREAM_NO_WAIT.
+ *
+ * @param stream   [the stream]
+ * @param data     [the buffer of bytes]
+ * @param len      [the size of buffer]
+ * @param time_out [the waiting time for trigger level]
+ *
+ * @return         [how many bytes are copied, it may be less than trigger]
+ * level on timeout.
+ */
+smc_uint32_t smc_stream_receive(smc_stream_t *stream,
+                                void *data,
+                                smc_uint32_t len,
+                                smc_int32_t time_out)
+{
+	smc_uint32_t start = smc_tick_get();
+	smc_uint32_t status;
+	smc_int32_t remaining;
+
+	if (len == 0U)
+		return 0;
+
+	while (time_out != SMC_STREAM_NO_WAIT) {
+		remaining = smc_stream_remaining(time_out, start);
+		if (remaining == 0)
+			break;
+
+		/* disable interrupt */
+		status = smc_cpu_disable_interrupt();
+
+		stream->reader_wanted = smc_stream_min(len, stream->trigger);
+		if (smc_stream_used(stream) >= stream->reader_wanted) {
+			smc_cpu_enable_interrupt(status);
+			break;
+		}
+
+		if (smc_stream_suspend(&stream->reader, remaining, status) == -SMC_TIMEOUT)
+			break;
+	}
+
+	return smc_stream_copy_out(stream, (smc_uint8_t *)data, len);
+}
+
+/**
+ * This function will return how many bytes are available to read
+ *
+ * @param stream [the stream]
+ */
+smc_uint32_t smc_stream_available(smc_stream_t *stream)
+{
+	return smc_stream_used(stream);
+}
+
+/**
+ * This function will return how many bytes are free to write
+ *
+ * @param stream [the stream]
+ */
+smc_uint32_t smc_stream_space(smc_stream_t *stream)
+{
+	return smc_stream_free(stream);
+}
+
+#endif /* SMC_USING_STREAM */
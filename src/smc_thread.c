@@ -57,10 +57,22 @@ void smc_thread_init(smc_thread_t *thread,
 	thread->sp = smc_thread_stack_init(entry, parameter,
 	                                   (smc_stack_t *)SMC_ALIGN_DOWN((smc_stack_t)stack_end, 4));
 	thread->priority             = priority;
+	thread->init_priority        = priority;
 	thread->init_slice_tick      = slice_tick;
 	thread->remaining_slice_tick = slice_tick;
 	thread->stat                 = SMC_THREAD_READY;
 	thread->error_num            = SMC_OK;
+#ifdef SMC_USING_THREAD_STATS
+	thread->stats.deadline       = 0;
+	smc_thread_stats_reset(thread);
+#endif
+
+#ifdef SMC_USING_WAKEUP_LATENCY
+	thread->wake_pending         = 0;
+#endif
+#ifdef SMC_USING_RWLOCK
+	smc_list_node_init(&thread->rwlock_list);
+#endif
 
 	smc_timer_init(&thread->timer, 0, smc_thread_timeout, thread, SMC_TIMER_DISABLE);
 	smc_list_add(&thread->rlist, &smc_list_head_table[priority]);
@@ -90,6 +102,41 @@ void smc_thread_abandon(void)
 	smc_cpu_enable_interrupt(status);
 }
 
+/**
+ * This function will suspend the current thread, the thread timer will resume
+ * it with -SMC_TIMEOUT error number if time out.
+ *
+ * @param time_out [the waiting ticks, negative for waiting forever]
+ *
+ * @note           [it must be invoked with interrupt disabled, and then]
+ * smc_scheduler() must be invoked.
+ */
+void smc_thread_suspend_timeout(smc_int32_t time_out)
+{
+	/* reset thread error number */
+	smc_thread_current->error_num = SMC_OK;
+
+	/* suspend the current thread */
+	smc_thread_suspend(smc_thread_current);
+
+	if (time_out >= 0) {
+		smc_uint8_t flag = SMC_TIMER_ONCE;
+
+		/* set timer timeout tick */
+		smc_timer_command(&smc_thread_current->timer,
+		                  SMC_TIMER_SET_TIMEOUT_TICK_IMMEDIATELY,
+		                  &time_out);
+
+		/* set timer flag */
+		smc_timer_command(&smc_thread_current->timer,
+		                  SMC_TIMER_SET_OPERATION_MODE,
+		                  &flag);
+
+		/* timer startup */
+		smc_timer_enable(&smc_thread_current->timer);
+	}
+}
+
 /**
  * This function will let current thread delay for some ticks.
  *
@@ -117,6 +164,164 @@ void smc_thread_delay(smc_uint32_t delay_tick)
 	smc_scheduler();
 }
 
+#ifdef SMC_USING_THREAD_STATS
+/**
+ * This function will set the relative deadline of a periodic thread
+ *
+ * @param thread   [the thread]
+ * @param deadline [the deadline ticks after release, 0 for the period]
+ */
+void smc_thread_set_deadline(smc_thread_t *thread, smc_uint32_t deadline)
+{
+	thread->stats.deadline = deadline;
+}
+
+/**
+ * This function will reset the timing statistics of a thread, and the
+ * deadline is kept.
+ *
+ * @param thread [the thread]
+ */
+void smc_thread_stats_reset(smc_thread_t *thread)
+{
+	smc_thread_stats_t *stats = &thread->stats;
+	smc_uint8_t i;
+
+	stats->releases        = 0;
+	stats->overruns        = 0;
+	stats->deadline_misses = 0;
+	stats->jitter_min      = 0xFFFFFFFFU;
+	stats->jitter_max      = 0;
+	for (i = 0; i < SMC_THREAD_JITTER_BUCKETS; i++)
+		stats->jitter_hist[i] = 0;
+}
+
+/**
+ * This function will record the release jitter of current thread, it's
+ * invoked when the thread runs after the release time.
+ *
+ * @param release [the release tick]
+ */
+static void smc_thread_stats_release(smc_uint32_t release)
+{
+	smc_thread_stats_t *stats = &smc_thread_current->stats;
+	smc_uint32_t cycle;
+	smc_uint32_t tick = smc_tick_get_stamp(&cycle);
+	smc_uint32_t jitter;
+	smc_uint8_t bucket = 0;
+
+	jitter = (smc_cpu_cycle_get() - cycle) / smc_cpu_cycles_per_us() +
+	         (tick - release) * SMC_US_PER_TICK;
+
+	if (jitter < stats->jitter_min)
+		stats->jitter_min = jitter;
+	if (jitter > stats->jitter_max)
+		stats->jitter_max = jitter;
+
+	/* bucket n counts jitter in [2^(n-1), 2^n), the last counts the rest */
+	while (jitter != 0U && bucket < SMC_THREAD_JITTER_BUCKETS - 1) {
+		jitter >>= 1;
+		bucket++;
+	}
+	stats->jitter_hist[bucket]++;
+	stats->releases++;
+}
+#endif
+
+/**
+ * This function will let current thread delay until an absolute release time,
+ * so the period doesn't drift with the execution time. The last_wake should
+ * be initialized by smc_tick_get() before the periodic loop.
+ *
+ * @param last_wake [the last release tick, it's updated to the next one]
+ * @param period    [the period ticks]
+ *
+ * @return          [SMC_OK, -SMC_TIMEOUT if the release time has passed]
+ */
+smc_int32_t smc_thread_delay_until(smc_uint32_t *last_wake, smc_uint32_t period)
+{
+	smc_uint32_t release = *last_wake + period;
+	smc_uint32_t status;
+	smc_uint32_t now;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	now = smc_tick_get();
+
+#ifdef SMC_USING_THREAD_STATS
+	{
+		smc_uint32_t deadline = smc_thread_current->stats.deadline;
+
+		/* the job is done at now, check it with the last release */
+		if (now - *last_wake >= (deadline ? deadline : period))
+			smc_thread_current->stats.deadline_misses++;
+	}
+#endif
+	*last_wake = release;
+
+	/* the job overruns its period, the next job is released already */
+	if ((smc_int32_t)(release - now) <= 0) {
+		smc_cpu_enable_interrupt(status);
+#ifdef SMC_USING_THREAD_STATS
+		/* the late job is released too, its jitter is counted */
+		smc_thread_current->stats.overruns++;
+		smc_thread_stats_release(release);
+#endif
+		return -SMC_TIMEOUT;
+	}
+
+	smc_thread_suspend_timeout(release - now);
+
+	smc_scheduler();
+
+	/* enable interrupt, and will make contex switch */
+	smc_cpu_enable_interrupt(status);
+
+#ifdef SMC_USING_THREAD_STATS
+	smc_thread_stats_release(release);
+#endif
+
+	return SMC_OK;
+}
+
+/**
+ * This function will let current thread delay for some microseconds. The
+ * whole ticks are slept and only the remainder is spun on the cpu cycle
+ * counter, a delay shorter than one tick is spun all.
+ *
+ * @param us [the delay microseconds]
+ *
+ * @note     [in interrupt or with scheduler locked, it spins for all.]
+ */
+void smc_thread_delay_us(smc_uint32_t us)
+{
+	smc_uint32_t tick = us / SMC_US_PER_TICK;
+
+	if (tick > 0U && smc_scheduler_is_blockable()) {
+		smc_uint32_t cycles_per_us = smc_cpu_cycles_per_us();
+
+		if (us <= 0xFFFFFFFFU / cycles_per_us) {
+			smc_uint32_t start = smc_cpu_cycle_get();
+			smc_uint32_t elapsed;
+
+			/**
+			 * The first tick is partial, so the sleep never exceeds the
+			 * delay, and the rest is measured from the start.
+			 */
+			smc_thread_delay(tick);
+			elapsed = (smc_cpu_cycle_get() - start) / cycles_per_us;
+			us      = elapsed < us ? us - elapsed : 0;
+		} else {
+			/* the cycle counter overflows, tick precision is enough */
+			smc_thread_delay(tick);
+			us %= SMC_US_PER_TICK;
+		}
+	}
+
+	smc_cpu_us_delay(us);
+}
+
 /**
  * This function wiil return the thread with the highest priority level.
  *
@@ -166,13 +371,17 @@ smc_int32_t smc_thread_suspend(smc_thread_t *thread)
 }
 
 /**
- * This function will resume a thread and put it to system ready queue.
+ * This function will wake a thread up and put it to system ready queue
+ * without schedule.
  *
- * @param thread [the thread to be resumed]
+ * @param thread [the thread to be waked up]
  *
  * @return       [the operation status, SMC_OK on OK, -SMC_ERROR on error]
+ *
+ * @note         [after this function call, the smc_scheduler() must be]
+ * invoked.
  */
-smc_int32_t smc_thread_resume(smc_thread_t *thread)
+smc_int32_t smc_thread_wakeup(smc_thread_t *thread)
 {
 	smc_uint32_t status;
 
@@ -195,11 +404,64 @@ smc_int32_t smc_thread_resume(smc_thread_t *thread)
 	             &(smc_list_head_table[thread->priority]));
 
 	smc_bitmap_set(thread->priority);
+
+#ifdef SMC_USING_WAKEUP_LATENCY
+	/* the current thread may be waked before switched out, it's running */
+	if (thread != smc_thread_current) {
+		thread->wake_cycle   = smc_cpu_cycle_get();
+		thread->wake_pending = 1;
+	}
+#endif
 	smc_cpu_enable_interrupt(status);
 
+	return SMC_OK;
+}
+
+/**
+ * This function will resume a thread and put it to system ready queue.
+ *
+ * @param thread [the thread to be resumed]
+ *
+ * @return       [the operation status, SMC_OK on OK, -SMC_ERROR on error]
+ */
+smc_int32_t smc_thread_resume(smc_thread_t *thread)
+{
+	if (smc_thread_wakeup(thread) != SMC_OK)
+		return -SMC_ERROR;
+
 	smc_scheduler();
 
 	return SMC_OK;
 }
 
+/**
+ * This function will change the priority of a thread. If the thread is
+ * ready, it will be moved to the ready queue of new priority.
+ *
+ * @param thread   [the thread]
+ * @param priority [the new priority]
+ *
+ * @note           [a suspended thread keeps its position in wait queue]
+ */
+void smc_thread_set_priority(smc_thread_t *thread, smc_uint8_t priority)
+{
+	smc_uint32_t status;
+
+	status = smc_cpu_disable_interrupt();
+
+	if (thread->stat == SMC_THREAD_READY) {
+		/* delete thread from the old ready queue */
+		smc_list_del_entry(&thread->rlist);
+		if (smc_list_is_empty(&smc_list_head_table[thread->priority]))
+			smc_bitmap_clear(thread->priority);
 
+		/* put thread to the new ready queue */
+		smc_list_add(&thread->rlist, &smc_list_head_table[priority]);
+		smc_bitmap_set(priority);
+	}
+	thread->priority = priority;
+
+	smc_cpu_enable_interrupt(status);
+
+	smc_scheduler();
+}
@@ -18,6 +18,8 @@ static smc_list_head_t smc_timer_resume_list =
 static smc_list_head_t smc_timer_list =
 	LIST_NODE_INIT(smc_timer_list);                       /* thread for all need to delay list head */
 
+static smc_uint32_t smc_timer_wakeups;                        /* ticks that have processed expired timers */
+
 /**
  * This function will init a timer
  *
@@ -38,11 +40,19 @@ void smc_timer_init(smc_timer_t *timer,
 	timer->init_tick    = tick;
 	timer->timeout_tick = tick;
 	timer->flag         = flag;
+#ifdef SMC_USING_TIMER_SLACK
+	timer->slack        = 0;
+	timer->late         = 0;
+	timer->deferrable   = 0;
+#endif
 	smc_list_node_init(&timer->tlist);
 }
 
 /**
- * This function will insert a timer to list
+ * This function will insert a timer to list. If the timer has slack, it
+ * will expire with the first timer in its slack window, so that they will
+ * be processed in one pass. The delay is recorded, so a periodic timer is
+ * re-armed from its nominal expiry.
  *
  * @param timer_insert [the timer will be inserted]
  * @param tick         [the tick for delay]
@@ -56,6 +66,9 @@ static void smc_timer_insert_list(smc_timer_t *timer_insert, smc_uint32_t tick)
 
 	/* disable interrupt */
 	status = smc_cpu_disable_interrupt();
+#ifdef SMC_USING_TIMER_SLACK
+	timer_insert->late = 0;
+#endif
 	/* find the position where the timer will be inserted */
 	for (pos = smc_timer_list.next; pos != &smc_timer_list; pos = pos->next) {
 		smc_timer_t *timer = smc_list_entry(pos, smc_timer_t, tlist);
@@ -63,6 +76,13 @@ static void smc_timer_insert_list(smc_timer_t *timer_insert, smc_uint32_t tick)
 
 		/* find the position where the timer will be inserted */
 		if (tick_sum >= tick) {
+#ifdef SMC_USING_TIMER_SLACK
+			/* coalesce with the timer expires in slack window */
+			if (tick_sum - tick <= timer_insert->slack) {
+				timer_insert->late = tick_sum - tick;
+				tick = tick_sum;
+			}
+#endif
 			timer_tick = timer->init_tick;
 			timer->init_tick -= tick + timer_tick - tick_sum;
 			break;
@@ -150,6 +170,14 @@ void smc_timer_command(smc_timer_t *timer, smc_uint8_t cmd, void *arg)
 	case SMC_TIMER_SET_OPERATION_MODE:
 		timer->flag = *(smc_uint8_t *)arg;
 		break;
+#ifdef SMC_USING_TIMER_SLACK
+	case SMC_TIMER_SET_SLACK:
+		timer->slack = *(smc_uint32_t *)arg;
+		break;
+	case SMC_TIMER_SET_DEFERRABLE:
+		timer->deferrable = *(smc_uint8_t *)arg;
+		break;
+#endif
 	default:
 		break;
 	}
@@ -201,6 +229,9 @@ void smc_timer_decrease(void)
 	timer = smc_list_entry(pos, smc_timer_t, tlist);
 	timer->init_tick--;
 
+	if (timer->init_tick == 0)
+		smc_timer_wakeups++;
+
 	/* put all thread of that delay tick is 0 to ready queue */
 	while ((timer->init_tick == 0) && (pos != &smc_timer_list)) {
 		pos = pos->next;
@@ -215,9 +246,17 @@ void smc_timer_decrease(void)
 		smc_timer_t *timer;
 
 		while (pos != &smc_timer_resume_list) {
-			pos = pos->next;
+			smc_uint32_t tick;
+
+			pos   = pos->next;
 			timer = smc_list_entry(pos->prev, smc_timer_t, tlist);
-			smc_timer_insert_list(timer, timer->timeout_tick);
+			tick  = timer->timeout_tick;
+#ifdef SMC_USING_TIMER_SLACK
+			/* the slack of this expiry doesn't move the next one */
+			if (tick != 0U)
+				tick -= timer->late % tick;
+#endif
+			smc_timer_insert_list(timer, tick);
 			smc_timer_process(timer);
 		}
 		smc_list_node_init(&smc_timer_resume_list);
@@ -229,3 +268,50 @@ void smc_timer_decrease(void)
 	/* do scheduler */
 	smc_scheduler();
 }
+
+/**
+ * The function will return the ticks to the next expiry that should wake up
+ * cpu, the deferrable timers are ignored. It's used by tickless idle to
+ * decide how long to sleep.
+ *
+ * @return [the ticks to the next expiry, SMC_TIMER_NO_TIMEOUT if no timer]
+ */
+smc_uint32_t smc_timer_next_timeout(void)
+{
+	smc_list_node_t *pos;
+	smc_uint32_t tick_sum = 0;
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	for (pos = smc_timer_list.next; pos != &smc_timer_list; pos = pos->next) {
+		smc_timer_t *timer = smc_list_entry(pos, smc_timer_t, tlist);
+
+		tick_sum += timer->init_tick;
+#ifdef SMC_USING_TIMER_SLACK
+		if (timer->deferrable)
+			continue;
+#endif
+		/* enable interrupt */
+		smc_cpu_enable_interrupt(status);
+
+		return tick_sum;
+	}
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	return SMC_TIMER_NO_TIMEOUT;
+}
+
+/**
+ * The function will return how many ticks have processed expired timers, it
+ * can be sampled to compute the timer wakeups per second.
+ *
+ * @return [the timer wakeup count]
+ */
+smc_uint32_t smc_timer_wakeup_count(void)
+{
+	return smc_timer_wakeups;
+}
@@ -0,0 +1,282 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-08-12
+ * Describe: This is a part of SMC-RTOS for publish/subscribe topic, the
+ *           latest message is read without lock and a small history is kept
+ *           for the subscribers reading in order.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include <string.h>
+#include "smc_topic.h"
+#include "smc_thread.h"
+#include "smc_core.h"
+#include "smc_waitq.h"
+#include "smc_cpu.h"
+
+#ifdef SMC_USING_TOPIC
+
+#define smc_topic_slot(topic, seq)  ((topic)->history + ((seq) & ((topic)->depth - 1)) * (topic)->size)
+
+/**
+ * This function will initialize a topic
+ *
+ * @param topic   [the topic]
+ * @param name    [the name of topic]
+ * @param history [the memory of depth messages]
+ * @param size    [the message size]
+ * @param depth   [how many messages are kept, it must be power of 2]
+ *
+ * @return        [SMC_OK on success, -SMC_ERROR if depth is invalid]
+ */
+smc_int32_t smc_topic_init(smc_topic_t *topic,
+                           const char *name,
+                           void *history,
+                           smc_uint16_t size,
+                           smc_uint16_t depth)
+{
+	if (depth == 0U || (depth & (depth - 1)) != 0U)
+		return -SMC_ERROR;
+
+	topic->name         = name;
+	topic->history      = (smc_uint8_t *)history;
+	topic->size         = size;
+	topic->depth        = depth;
+	topic->published    = 0;
+	topic->window_start = smc_tick_get();
+	topic->window_count = 0;
+	topic->rate         = 0;
+	topic->lag_max      = 0;
+	smc_waitq_init(&topic->waitq, SMC_WAITQ_PRIO);
+
+	return SMC_OK;
+}
+
+/**
+ * This function will publish a message and wake all the waiting
+ * subscribers. The message is copied with interrupt disabled, so the
+ * publishers are serialized and the message should be small. It can be
+ * invoked in interrupt handle.
+ *
+ * @param topic [the topic]
+ * @param msg   [the message]
+ */
+void smc_topic_publish(smc_topic_t *topic, const void *msg)
+{
+	smc_thread_t *thread;
+	smc_uint32_t status;
+	smc_uint32_t tick;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	/**
+	 * The reader never runs in the middle of copy, it only needs to know
+	 * whether the slot is overwritten after its copy starts.
+	 */
+	memcpy(smc_topic_slot(topic, topic->published), msg, topic->size);
+	smc_barrier();
+	topic->published++;
+
+	/* the rate of the last second */
+	tick = smc_tick_get();
+	topic->window_count++;
+	if (tick - topic->window_start >= SMC_TICKS_PER_SECOND) {
+		topic->rate = topic->window_count * SMC_TICKS_PER_SECOND /
+		              (tick - topic->window_start);
+		topic->window_start = tick;
+		topic->window_count = 0;
+	}
+
+	/* wake all the subscribers, and schedule once */
+	if ((thread = smc_waitq_first(&topic->waitq)) != NULL) {
+		do {
+			smc_thread_wakeup(thread);
+		} while ((thread = smc_waitq_first(&topic->waitq)) != NULL);
+		smc_scheduler();
+	}
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+}
+
+/**
+ * This function will return the publish rate of the last second
+ *
+ * @param topic [the topic]
+ *
+ * @return      [messages per second]
+ */
+smc_uint32_t smc_topic_rate(smc_topic_t *topic)
+{
+	smc_uint32_t status;
+	smc_uint32_t elapsed;
+	smc_uint32_t rate;
+
+	/* disable interrupt */
+	status  = smc_cpu_disable_interrupt();
+	elapsed = smc_tick_get() - topic->window_start;
+	rate    = topic->rate;
+
+	/* the publisher stops, nobody closes the window */
+	if (elapsed >= SMC_TICKS_PER_SECOND)
+		rate = topic->window_count * SMC_TICKS_PER_SECOND / elapsed;
+	smc_cpu_enable_interrupt(status);
+
+	return rate;
+}
+
+/**
+ * This function will subscribe a topic, only the messages published since
+ * now are unread.
+ *
+ * @param sub   [the subscriber]
+ * @param topic [the topic]
+ */
+void smc_topic_subscribe(smc_subscriber_t *sub, smc_topic_t *topic)
+{
+	sub->topic   = topic;
+	sub->next    = topic->published;
+	sub->lag_max = 0;
+	sub->lost    = 0;
+}
+
+/**
+ * This function will copy a message and check it isn't overwritten
+ *
+ * @param topic [the topic]
+ * @param seq   [the sequence of message]
+ * @param msg   [the buffer of message]
+ *
+ * @return      [1 if the copy is valid, 0 if it must be retried]
+ */
+static smc_bool_t smc_topic_copy(smc_topic_t *topic, smc_uint32_t seq, void *msg)
+{
+	smc_barrier();
+	memcpy(msg, smc_topic_slot(topic, seq), topic->size);
+	smc_barrier();
+
+	/* the slot is reused by the message depth later */
+	return topic->published - seq <= topic->depth;
+}
+
+/**
+ * This function will record the unread messages when reading
+ *
+ * @param sub [the subscriber]
+ * @param seq [the sequence counter of topic]
+ */
+static void smc_topic_lag(smc_subscriber_t *sub, smc_uint32_t seq)
+{
+	smc_uint32_t lag = seq - sub->next;
+
+	if (lag > sub->lag_max)
+		sub->lag_max = lag;
+
+	/* a racy maximum is good enough for statistics */
+	if (lag > sub->topic->lag_max)
+		sub->topic->lag_max = lag;
+}
+
+/**
+ * This function will read the latest message without lock, the read is
+ * retried if the message is overwritten while copying. All the unread
+ * messages are consumed.
+ *
+ * @param sub [the subscriber]
+ * @param msg [the buffer of message]
+ *
+ * @return    [how many messages are unread before, -SMC_ERROR if nothing]
+ * is published.
+ */
+smc_int32_t smc_topic_read_latest(smc_subscriber_t *sub, void *msg)
+{
+	smc_topic_t *topic = sub->topic;
+	smc_uint32_t seq;
+	smc_int32_t unread;
+
+	do {
+		seq = topic->published;
+		if (seq == 0U)
+			return -SMC_ERROR;
+	} while (!smc_topic_copy(topic, seq - 1, msg));
+
+	smc_topic_lag(sub, seq);
+	unread    = (smc_int32_t)(seq - sub->next);
+	sub->next = seq;
+
+	return unread;
+}
+
+/**
+ * This function will read the oldest unread message in history without
+ * lock. The messages overwritten before read are counted as lost.
+ *
+ * @param sub [the subscriber]
+ * @param msg [the buffer of message]
+ *
+ * @return    [SMC_OK on success, -SMC_TIMEOUT if there is no unread message]
+ */
+smc_int32_t smc_topic_read_next(smc_subscriber_t *sub, void *msg)
+{
+	smc_topic_t *topic = sub->topic;
+	smc_uint32_t seq;
+
+	do {
+		seq = topic->published;
+		if (seq == sub->next)
+			return -SMC_TIMEOUT;
+
+		/* skip to the oldest message in history */
+		if (seq - sub->next > topic->depth) {
+			sub->lost += seq - sub->next - topic->depth;
+			sub->next  = seq - topic->depth;
+		}
+	} while (!smc_topic_copy(topic, sub->next, msg));
+
+	smc_topic_lag(sub, seq);
+	sub->next++;
+
+	return SMC_OK;
+}
+
+/**
+ * This function will wait until there is an unread message
+ *
+ * @param sub      [the subscriber]
+ * @param time_out [the waiting time]
+ *
+ * @return         [error number]
+ */
+smc_int32_t smc_topic_wait(smc_subscriber_t *sub, smc_int32_t time_out)
+{
+	smc_topic_t *topic = sub->topic;
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	if (topic->published != sub->next) {
+		smc_cpu_enable_interrupt(status);
+		return SMC_OK;
+	}
+
+	if (time_out == SMC_TOPIC_NO_WAIT) {
+		smc_cpu_enable_interrupt(status);
+		return -SMC_TIMEOUT;
+	}
+
+	/* suspend the current thread to topic wait queue */
+	smc_waitq_suspend(&topic->waitq, time_out);
+
+	smc_scheduler();
+
+	/* enable interrupt, and will make contex switch */
+	smc_cpu_enable_interrupt(status);
+
+	return smc_thread_current->error_num;
+}
+
+#endif /* SMC_USING_TOPIC */
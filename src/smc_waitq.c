@@ -0,0 +1,96 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-10
+ * Describe: This is a part of SMC-RTOS for wait queue
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_waitq.h"
+#include "smc_list.h"
+#include "smc_core.h"
+#include "smc_thread.h"
+
+/**
+ * This function will initialize a wait queue
+ *
+ * @param waitq  [the wait queue]
+ * @param policy [the wait queue policy, SMC_WAITQ_PRIO, SMC_WAITQ_FIFO or]
+ * SMC_WAITQ_LIFO
+ */
+void smc_waitq_init(smc_waitq_t *waitq, smc_uint8_t policy)
+{
+	smc_list_node_init(&waitq->wlist);
+	waitq->policy = policy;
+}
+
+/**
+ * This function will put a suspended thread to wait queue. With the PRIO
+ * policy the thread is put behind the waiting threads of the same or higher
+ * priority, so the cost grows with the number of waiting threads.
+ *
+ * @param waitq  [the wait queue]
+ * @param thread [the suspended thread]
+ *
+ * @note         [it must be invoked with interrupt disabled]
+ */
+void smc_waitq_add(smc_waitq_t *waitq, smc_thread_t *thread)
+{
+	smc_list_node_t *pos;
+	smc_thread_t *waiter;
+
+	switch (waitq->policy) {
+	case SMC_WAITQ_PRIO:
+		for (pos = waitq->wlist.next; pos != &waitq->wlist; pos = pos->next) {
+			waiter = smc_list_entry(pos, smc_thread_t, rlist);
+			if (waiter->priority > thread->priority)
+				break;
+		}
+		smc_list_add_tail(&thread->rlist, pos);
+		break;
+	case SMC_WAITQ_FIFO:
+		smc_list_add_tail(&thread->rlist, &waitq->wlist);
+		break;
+	case SMC_WAITQ_LIFO:
+	default:
+		smc_list_add(&thread->rlist, &waitq->wlist);
+		break;
+	}
+}
+
+/**
+ * This function will suspend the current thread to wait queue, the thread
+ * will be resumed with -SMC_TIMEOUT error number if time out.
+ *
+ * @param waitq    [the wait queue]
+ * @param time_out [the waiting ticks or SMC_WAITQ_WAIT_FOREVER]
+ *
+ * @note           [it must be invoked with interrupt disabled, and then]
+ * smc_scheduler() must be invoked.
+ */
+void smc_waitq_suspend(smc_waitq_t *waitq, smc_int32_t time_out)
+{
+	smc_thread_suspend_timeout(time_out);
+
+	/* add the current thread to wait queue */
+	smc_waitq_add(waitq, smc_thread_current);
+}
+
+/**
+ * This function will return the thread which should be waked first.
+ *
+ * @param waitq [the wait queue]
+ *
+ * @return      [the first thread, NULL if wait queue is empty]
+ *
+ * @note        [it must be invoked with interrupt disabled]
+ */
+smc_thread_t *smc_waitq_first(smc_waitq_t *waitq)
+{
+	/* the threads removed by timeout or resume have left the list */
+	if (smc_list_is_empty(&waitq->wlist))
+		return NULL;
+
+	return smc_list_first_entry(&waitq->wlist, smc_thread_t, rlist);
+}
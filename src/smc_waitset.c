@@ -0,0 +1,189 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-24
+ * Describe: This is a part of SMC-RTOS for wait set, a thread can wait for
+ *           several kernel objects at once.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_waitset.h"
+#include "smc_list.h"
+#include "smc_thread.h"
+#include "smc_core.h"
+#include "smc_sem.h"
+
+#ifdef SMC_USING_WAITSET
+/**
+ * This function will initialize an empty wait set, it's cheap enough to be
+ * invoked before each wait.
+ *
+ * @param set [the wait set]
+ */
+void smc_waitset_init(smc_waitset_t *set)
+{
+	set->count = 0;
+}
+
+/**
+ * The poll node notify function of wait set, it wakes up the waiting thread
+ *
+ * @param node [the poll node]
+ */
+static void smc_waitset_notify(smc_poll_node_t *node)
+{
+	smc_waitset_entry_t *entry = container_of(node, smc_waitset_entry_t, node);
+
+	smc_thread_wakeup(entry->thread);
+}
+
+/**
+ * This function will add a kernel object to wait set. The object should
+ * notify its poll list by smc_poll_notify() when it becomes available.
+ *
+ * @param set    [the wait set]
+ * @param object [the kernel object]
+ * @param head   [the poll list of object]
+ * @param take   [the function to take the object without wait]
+ *
+ * @return       [the index of object in wait set, -SMC_NOMEM if it's full]
+ */
+smc_int32_t smc_waitset_add(smc_waitset_t *set,
+                            void *object,
+                            smc_list_head_t *head,
+                            smc_int32_t (*take)(void *object))
+{
+	smc_waitset_entry_t *entry;
+
+	if (set->count >= SMC_WAITSET_MAX)
+		return -SMC_NOMEM;
+
+	entry              = &set->entry[set->count];
+	entry->object      = object;
+	entry->head        = head;
+	entry->take        = take;
+	entry->node.notify = smc_waitset_notify;
+
+	return set->count++;
+}
+
+#ifdef SMC_USING_SEMAPHORE
+/**
+ * The take function of semaphore for wait set
+ *
+ * @param object [the semaphore]
+ *
+ * @return       [error number]
+ */
+static smc_int32_t smc_waitset_sem_take(void *object)
+{
+	return smc_sem_try_take((smc_sem_t *)object);
+}
+
+/**
+ * This function will add a semaphore to wait set
+ *
+ * @param set [the wait set]
+ * @param sem [the semaphore]
+ *
+ * @return    [the index of semaphore in wait set, -SMC_NOMEM if it's full]
+ */
+smc_int32_t smc_waitset_add_sem(smc_waitset_t *set, smc_sem_t *sem)
+{
+	return smc_waitset_add(set, sem, &sem->plist, smc_waitset_sem_take);
+}
+#endif
+
+/**
+ * This function will wait until any object in wait set is available, and
+ * take it.
+ *
+ * @param set      [the wait set]
+ * @param time_out [the waiting time]
+ *
+ * @return         [the index of the taken object, -SMC_TIMEOUT if time out]
+ */
+smc_int32_t smc_waitset_wait(smc_waitset_t *set, smc_int32_t time_out)
+{
+	smc_uint32_t start = smc_tick_get();
+	smc_uint32_t status;
+	smc_uint8_t i;
+
+	while (1) {
+		smc_int32_t remaining = time_out;
+
+		/* disable interrupt */
+		status = smc_cpu_disable_interrupt();
+
+		for (i = 0; i < set->count; i++) {
+			if (set->entry[i].take(set->entry[i].object) == SMC_OK) {
+				smc_cpu_enable_interrupt(status);
+				return i;
+			}
+		}
+
+		/* the waked thread may lose the object, only wait for the rest time */
+		if (time_out != SMC_WAITSET_WAIT_FOREVER)
+			remaining = time_out - (smc_int32_t)(smc_tick_get() - start);
+
+		if (time_out != SMC_WAITSET_WAIT_FOREVER && remaining <= 0) {
+			smc_cpu_enable_interrupt(status);
+			return -SMC_TIMEOUT;
+		}
+
+		/* poll all the objects, the first notify wakes the thread */
+		for (i = 0; i < set->count; i++) {
+			set->entry[i].thread = smc_thread_current;
+			smc_list_add_tail(&set->entry[i].node.plist, set->entry[i].head);
+		}
+
+		smc_thread_suspend_timeout(remaining);
+
+		smc_scheduler();
+
+		/* enable interrupt, and will make contex switch */
+		smc_cpu_enable_interrupt(status);
+
+		/* disable interrupt */
+		status = smc_cpu_disable_interrupt();
+
+		for (i = 0; i < set->count; i++)
+			smc_list_del_entry(&set->entry[i].node.plist);
+
+		/* enable interrupt */
+		smc_cpu_enable_interrupt(status);
+
+		if (smc_thread_current->error_num == -SMC_TIMEOUT)
+			return -SMC_TIMEOUT;
+	}
+}
+
+/**
+ * This function will notify all the poll nodes in poll list of an object
+ *
+ * @param head [the poll list of object]
+ *
+ * @return     [1 if any node is notified, 0 if the list is empty]
+ *
+ * @note       [it must be invoked with interrupt disabled]
+ */
+smc_bool_t smc_poll_notify(smc_list_head_t *head)
+{
+	smc_list_node_t *pos = head->next;
+
+	if (pos == head)
+		return 0;
+
+	/* the node may be removed by notify function */
+	while (pos != head) {
+		smc_poll_node_t *node = smc_list_entry(pos, smc_poll_node_t, plist);
+
+		pos = pos->next;
+		node->notify(node);
+	}
+
+	return 1;
+}
+
+#endif /* SMC_USING_WAITSET */
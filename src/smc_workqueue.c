@@ -0,0 +1,266 @@
+/**
+ * Author:   songmuchun <smcdef@163.com>
+ * Date:     2017-07-25
+ * Describe: This is a part of SMC-RTOS for work queue, many short deferred
+ *           works can share the stacks of a few worker threads.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+#include "smc_workqueue.h"
+#include "smc_list.h"
+#include "smc_thread.h"
+#include "smc_timer.h"
+#include "smc_sem.h"
+#include "smc_cpu.h"
+
+#ifdef SMC_USING_WORKQUEUE
+/**
+ * This function will put a work item to pending list, and wake up a worker
+ *
+ * @param work [the work item]
+ *
+ * @note       [it must be invoked with interrupt disabled]
+ */
+static void smc_work_queue(smc_work_t *work)
+{
+	work->state = SMC_WORK_QUEUED;
+	smc_list_add_tail(&work->wlist, &work->wq->wlist);
+	smc_sem_release(&work->wq->sem);
+}
+
+/**
+ * The entry function of worker thread
+ *
+ * @param parameter [the work queue]
+ */
+static void smc_worker_entry(void *parameter)
+{
+	smc_workqueue_t *wq = (smc_workqueue_t *)parameter;
+	smc_work_t *work;
+	smc_uint32_t status;
+
+	while (1) {
+		smc_sem_pend(&wq->sem, SMC_SEM_WAIT_FOREVER);
+
+		/* disable interrupt */
+		status = smc_cpu_disable_interrupt();
+
+		/* the work may be cancelled */
+		if (smc_list_is_empty(&wq->wlist)) {
+			smc_cpu_enable_interrupt(status);
+			continue;
+		}
+
+		work = smc_list_entry(wq->wlist.next, smc_work_t, wlist);
+		smc_list_del_entry(&work->wlist);
+		work->state = SMC_WORK_RUNNING;
+
+		/* enable interrupt */
+		smc_cpu_enable_interrupt(status);
+
+		work->func(work->arg);
+
+		/* disable interrupt */
+		status = smc_cpu_disable_interrupt();
+
+		/* the work is submitted again while running */
+		if (work->state == SMC_WORK_REQUEUED)
+			smc_work_queue(work);
+		else
+			work->state = SMC_WORK_IDLE;
+
+		/* enable interrupt */
+		smc_cpu_enable_interrupt(status);
+	}
+}
+
+/**
+ * This function will initialize a work queue and its worker threads. The
+ * stacks of all workers are in one contiguous memory.
+ *
+ * @param wq          [the work queue]
+ * @param workers     [the static thread objects array of workers]
+ * @param worker_num  [the number of workers]
+ * @param stack_start [the start address of the stacks of all workers]
+ * @param stack_size  [the stack size of each worker]
+ * @param priority    [the priority of workers]
+ */
+void smc_workqueue_init(smc_workqueue_t *wq,
+                        smc_thread_t *workers,
+                        smc_uint8_t worker_num,
+                        void *stack_start,
+                        smc_uint32_t stack_size,
+                        smc_uint8_t priority)
+{
+	smc_uint8_t i;
+
+	smc_list_node_init(&wq->wlist);
+	smc_sem_init_policy(&wq->sem, 0, SMC_WAITQ_FIFO);
+
+	for (i = 0; i < worker_num; i++)
+		smc_thread_init(&workers[i],
+		                smc_worker_entry,
+		                wq,
+		                priority,
+		                (smc_uint8_t *)stack_start + i * stack_size,
+		                stack_size,
+		                SMC_WORKQUEUE_SLICE_TICK);
+}
+
+/**
+ * This function will initialize a work item
+ *
+ * @param work [the work item]
+ * @param func [the function of work]
+ * @param arg  [the argument of work function]
+ *
+ * @note       [the worker updates the work after its function returns, so]
+ * the function can't free the work item.
+ */
+void smc_work_init(smc_work_t *work, void (*func)(void *arg), void *arg)
+{
+	work->func  = func;
+	work->arg   = arg;
+	work->wq    = NULL;
+	work->state = SMC_WORK_IDLE;
+	smc_list_node_init(&work->wlist);
+	smc_timer_init(&work->timer, 0, NULL, NULL, SMC_TIMER_DISABLE);
+}
+
+/**
+ * This function will submit a work item to work queue, it can be invoked
+ * in interrupt handle. A running work is queued again when its function
+ * returns, so it never runs on two workers at once.
+ *
+ * @param wq   [the work queue]
+ * @param work [the work item]
+ *
+ * @return     [SMC_OK on success, -SMC_BUSY if the work is pending]
+ */
+smc_int32_t smc_work_submit(smc_workqueue_t *wq, smc_work_t *work)
+{
+	smc_uint32_t status;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	switch (work->state) {
+	case SMC_WORK_IDLE:
+		work->wq = wq;
+		smc_work_queue(work);
+		break;
+	case SMC_WORK_RUNNING:
+		/* the worker queues it to the work queue it runs on */
+		work->state = SMC_WORK_REQUEUED;
+		break;
+	default:
+		smc_cpu_enable_interrupt(status);
+		return -SMC_BUSY;
+	}
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	return SMC_OK;
+}
+
+/**
+ * The timeout function of delayed work, invoked in the timer tick interrupt
+ *
+ * @param parameter [the work item]
+ */
+static void smc_work_timeout(void *parameter)
+{
+	smc_work_queue((smc_work_t *)parameter);
+}
+
+/**
+ * This function will submit a work item to work queue after some ticks, it
+ * can be invoked in interrupt handle.
+ *
+ * @param wq   [the work queue]
+ * @param work [the work item]
+ * @param tick [the delay ticks]
+ *
+ * @return     [SMC_OK on success, -SMC_BUSY if the work is pending or]
+ * running.
+ */
+smc_int32_t smc_work_submit_delayed(smc_workqueue_t *wq,
+                                    smc_work_t *work,
+                                    smc_uint32_t tick)
+{
+	smc_uint32_t status;
+
+	if (tick == 0)
+		return smc_work_submit(wq, work);
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	if (work->state != SMC_WORK_IDLE) {
+		smc_cpu_enable_interrupt(status);
+		return -SMC_BUSY;
+	}
+
+	work->wq    = wq;
+	work->state = SMC_WORK_DELAYED;
+	smc_timer_init(&work->timer, tick, smc_work_timeout, work, SMC_TIMER_ONCE);
+	smc_timer_enable(&work->timer);
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	return SMC_OK;
+}
+
+/**
+ * This function will cancel a pending work item, the submission during a
+ * run is cancelled too.
+ *
+ * @param work [the work item]
+ *
+ * @return     [SMC_OK on success, -SMC_BUSY if the work is running, and]
+ * -SMC_ERROR if the work is idle.
+ *
+ * @note       [a running work can't be cancelled, it goes on until its]
+ * function returns.
+ */
+smc_int32_t smc_work_cancel(smc_work_t *work)
+{
+	smc_uint32_t status;
+	smc_int32_t error_num = SMC_OK;
+
+	/* disable interrupt */
+	status = smc_cpu_disable_interrupt();
+
+	switch (work->state) {
+	case SMC_WORK_DELAYED:
+		smc_timer_disable(&work->timer);
+		work->state = SMC_WORK_IDLE;
+		break;
+	case SMC_WORK_QUEUED:
+		/* the semaphore count is left, worker will find the list empty */
+		smc_list_del_entry(&work->wlist);
+		work->state = SMC_WORK_IDLE;
+		break;
+	case SMC_WORK_REQUEUED:
+		work->state = SMC_WORK_RUNNING;
+		error_num   = -SMC_BUSY;
+		break;
+	case SMC_WORK_RUNNING:
+		error_num = -SMC_BUSY;
+		break;
+	default:
+		error_num = -SMC_ERROR;
+		break;
+	}
+
+	/* enable interrupt */
+	smc_cpu_enable_interrupt(status);
+
+	return error_num;
+}
+
+#endif /* SMC_USING_WORKQUEUE */
@@ -0,0 +1,429 @@
+#!/usr/bin/env python3
+#
+# Author:   songmuchun <smcdef@163.com>
+# Date:     2017-08-06
+# Describe: This is a host tool of SMC-RTOS, the response-time analysis of
+#           fixed-priority preemptive scheduling.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation.
+#
+"""Offline schedulability analysis for SMC-RTOS.
+
+The system is described by a JSON file, the fields follow the arguments of
+smc_thread_init() and smc_timer_init():
+
+    {
+        "ticks_per_second": 200,
+        "overhead": {"tick_us": 3.0, "switch_us": 1.2},
+        "threads": [
+            {"name": "ctrl", "priority": 2, "period": 2, "wcet_us": 900,
+             "slice_tick": 20, "locks": [{"sem": "bus", "cs_us": 40}]}
+        ],
+        "timers": [
+            {"name": "led", "tick": 100, "flag": "periodic", "wcet_us": 5}
+        ],
+        "interrupts": [
+            {"name": "uart", "min_interval_us": 87, "wcet_us": 4}
+        ],
+        "locks": {"bus": "sem"}
+    }
+
+Units:
+    period, deadline, tick   in ticks, as smc_thread_delay_until() and
+                             smc_timer_init() take
+    *_us                     in microseconds
+
+The lower number is the higher priority, the same as the kernel. Threads of
+the same priority are served round robin, each slice expiry costs a switch.
+
+Overheads are measured on the target:
+    tick_us    the cost of SysTick handler without timer callbacks, e.g. the
+               DWT cycles around smc_time_tick() with an empty timer list
+    switch_us  the cost of one thread switch, e.g. the cycles from
+               smc_scheduler() to the first instruction of the new thread
+    irq_us     the cost of smc_enter_interrupt() and smc_exit_interrupt(),
+               added to every interrupt and the tick
+
+Locks:
+    "sem"      semaphore, no priority inheritance. The blocking includes the
+               threads with the priority between the blocked thread and the
+               lock holder, the tool warns about it.
+    "rwlock"   reader-writer lock, the writer inherits the priority
+    "irq"      critical section with interrupt disabled, it blocks every
+               thread and the interrupts
+"""
+
+import argparse
+import json
+import math
+import os
+import re
+import sys
+
+IDLE_PRIORITY_DEFAULT = 31
+ITERATION_MAX = 10000
+
+
+class AnalysisError(Exception):
+    pass
+
+
+def read_config(path):
+    """Read SMC_TICKS_PER_SECOND and SMC_PRIORITY_MAX from smc_config.h"""
+    config = {}
+
+    try:
+        with open(path) as f:
+            text = f.read()
+    except OSError:
+        return config
+
+    for key in ("SMC_TICKS_PER_SECOND", "SMC_PRIORITY_MAX"):
+        match = re.search(r"^#define\s+%s\s+(\d+)" % key, text, re.M)
+        if match:
+            config[key] = int(match.group(1))
+
+    return config
+
+
+class Thread:
+    def __init__(self, desc, tick_us, overhead):
+        try:
+            self.name = desc["name"]
+            self.priority = int(desc["priority"])
+            self.period = float(desc["period"]) * tick_us
+            self.wcet = float(desc["wcet_us"])
+        except KeyError as e:
+            raise AnalysisError("thread needs %s" % e)
+
+        self.deadline = float(desc.get("deadline", desc["period"])) * tick_us
+        self.jitter = float(desc.get("jitter_us", 0))
+        self.slice = float(desc.get("slice_tick", 20)) * tick_us
+        self.locks = desc.get("locks", [])
+        self.overhead = overhead
+        self.peers = []
+        self.cost = self.wcet
+        self.blocking = 0.0
+        self.blocker = None
+        self.response = None
+        self.warnings = []
+
+        if self.period <= 0 or self.wcet <= 0:
+            raise AnalysisError("%s: period and wcet must be positive" %
+                                self.name)
+
+    def finish(self):
+        """Charge the switch cost: preempt in and out once per job, and once
+        more per slice expiry if it shares the priority"""
+        switches = 2
+        if self.peers:
+            switches += math.ceil(self.wcet / self.slice)
+        self.cost = self.wcet + switches * self.overhead["switch_us"]
+
+    def cs_max(self, lock):
+        return max([l["cs_us"] for l in self.locks if l.get("sem") == lock] or
+                   [0.0])
+
+    def lock_names(self):
+        return set(l["sem"] for l in self.locks)
+
+
+class Source:
+    """The work in interrupt context, it preempts every thread"""
+
+    def __init__(self, name, interval, cost):
+        self.name = name
+        self.interval = interval
+        self.cost = cost
+
+    def demand(self, window):
+        if self.interval is None:
+            return self.cost
+        return math.ceil(window / self.interval) * self.cost
+
+
+class System:
+    def __init__(self, desc, config):
+        self.ticks_per_second = int(desc.get("ticks_per_second",
+                                    config.get("SMC_TICKS_PER_SECOND", 200)))
+        self.priority_max = int(desc.get("priority_max",
+                                config.get("SMC_PRIORITY_MAX",
+                                           IDLE_PRIORITY_DEFAULT + 1)))
+        self.tick_us = 1e6 / self.ticks_per_second
+
+        overhead = desc.get("overhead", {})
+        self.overhead = {
+            "tick_us": float(overhead.get("tick_us", 0)),
+            "switch_us": float(overhead.get("switch_us", 0)),
+            "irq_us": float(overhead.get("irq_us", 0)),
+        }
+        self.lock_kind = desc.get("locks", {})
+        self.threads = [Thread(t, self.tick_us, self.overhead)
+                        for t in desc.get("threads", [])]
+        self.sources = []
+        self.warnings = []
+
+        if not self.threads:
+            raise AnalysisError("no thread to analyse")
+
+        self.check_threads()
+        self.build_sources(desc)
+        self.build_blocking()
+
+    def check_threads(self):
+        idle = self.priority_max - 1
+        names = set()
+
+        for t in self.threads:
+            if t.name in names:
+                raise AnalysisError("duplicate thread %s" % t.name)
+            names.add(t.name)
+            if not 0 <= t.priority < idle:
+                raise AnalysisError("%s: priority must be in [0, %d)" %
+                                    (t.name, idle))
+            for l in t.locks:
+                if "sem" not in l or "cs_us" not in l:
+                    raise AnalysisError("%s: lock needs sem and cs_us" %
+                                        t.name)
+                l["cs_us"] = float(l["cs_us"])
+                if l["cs_us"] > t.wcet:
+                    raise AnalysisError("%s: critical section longer than "
+                                        "wcet" % t.name)
+
+        for t in self.threads:
+            t.peers = [p for p in self.threads
+                       if p is not t and p.priority == t.priority]
+            t.finish()
+
+        # rate monotonic order is optimal for implicit deadlines
+        for a in self.threads:
+            for b in self.threads:
+                if a.priority < b.priority and a.deadline > b.deadline:
+                    self.warnings.append(
+                        "%s has higher priority but longer deadline than %s, "
+                        "deadline monotonic order may do better" %
+                        (a.name, b.name))
+
+    def build_sources(self, desc):
+        irq_us = self.overhead["irq_us"]
+
+        # SysTick, the timer callbacks run in it
+        self.sources.append(Source("tick", self.tick_us,
+                                   self.overhead["tick_us"] + irq_us))
+
+        for timer in desc.get("timers", []):
+            wcet = float(timer["wcet_us"])
+            flag = timer.get("flag", "periodic")
+            if flag == "periodic":
+                interval = float(timer["tick"]) * self.tick_us
+            elif flag == "once":
+                interval = None
+            else:
+                raise AnalysisError("timer %s: unknown flag %s" %
+                                    (timer["name"], flag))
+            self.sources.append(Source("timer " + timer["name"], interval,
+                                       wcet))
+
+        for irq in desc.get("interrupts", []):
+            self.sources.append(Source("irq " + irq["name"],
+                                       float(irq["min_interval_us"]),
+                                       float(irq["wcet_us"]) + irq_us))
+
+    def kind(self, lock):
+        kind = self.lock_kind.get(lock, "sem")
+        if kind not in ("sem", "rwlock", "irq"):
+            raise AnalysisError("lock %s: unknown kind %s" % (lock, kind))
+        return kind
+
+    def build_blocking(self):
+        irq_cs = max([l["cs_us"] for t in self.threads for l in t.locks
+                      if self.kind(l["sem"]) == "irq"] or [0.0])
+
+        for t in self.threads:
+            lower = [l for l in self.threads if l.priority > t.priority]
+            blocking = irq_cs
+            blocker = "interrupt disabled" if irq_cs else None
+
+            # priority inheritance: once per resource and per lower thread
+            inherit = {}
+            for lock in t.lock_names():
+                if self.kind(lock) != "rwlock":
+                    continue
+                for l in lower:
+                    cs = l.cs_max(lock)
+                    if cs > inherit.get(l.name, (0.0, None))[0]:
+                        inherit[l.name] = (cs, lock)
+            pip = sum(cs for cs, _ in inherit.values())
+            if pip:
+                blocking += pip
+                blocker = ", ".join("%s on %s" % (n, lock)
+                                    for n, (_, lock) in inherit.items())
+
+            # no inheritance: the holder is preempted by the middle threads
+            worst = 0.0
+            for lock in t.lock_names():
+                if self.kind(lock) != "sem":
+                    continue
+                for l in lower:
+                    cs = l.cs_max(lock)
+                    if cs == 0:
+                        continue
+                    middle = [m for m in self.threads
+                              if t.priority < m.priority < l.priority]
+                    length = self.busy(cs, middle, t.deadline)
+                    if length is None:
+                        t.warnings.append("unbounded inversion by %s on %s" %
+                                          (l.name, lock))
+                        length = math.inf
+                    elif middle:
+                        t.warnings.append(
+                            "inversion by %s on %s is prolonged by %s" %
+                            (l.name, lock,
+                             ", ".join(m.name for m in middle)))
+                    if length > worst:
+                        worst = length
+                        blocker = "%s on %s" % (l.name, lock)
+            t.blocking = blocking + worst
+            t.blocker = blocker
+
+    def busy(self, base, threads, limit):
+        """The fixed point of base plus the demand of threads, None if it's
+        longer than limit"""
+        window = base
+        for _ in range(ITERATION_MAX):
+            demand = base + sum(math.ceil(window / h.period) * h.cost
+                                for h in threads)
+            if demand > limit:
+                return None
+            if demand == window:
+                return window
+            window = demand
+        return None
+
+    def response(self, t):
+        """Worst-case response time of t measured from its release, the
+        release jitter of the higher priority threads is considered"""
+        higher = [h for h in self.threads
+                  if h.priority < t.priority or h in t.peers]
+        base = t.cost + t.blocking
+        window = base
+
+        if math.isinf(base):
+            return None
+
+        for _ in range(ITERATION_MAX):
+            demand = base
+            demand += sum(math.ceil((window + h.jitter) / h.period) * h.cost
+                          for h in higher)
+            demand += sum(s.demand(window) for s in self.sources)
+            if demand + t.jitter > t.deadline:
+                return None
+            if demand == window:
+                return window + t.jitter
+            window = demand
+        return None
+
+    def analyse(self):
+        for t in self.threads:
+            t.response = self.response(t)
+
+        cost = [t.cost / t.period for t in self.threads]
+        irq = sum(s.cost / s.interval for s in self.sources if s.interval)
+        n = len(self.threads)
+
+        return {
+            "utilization": sum(cost) + irq,
+            "thread_utilization": sum(cost),
+            "interrupt_utilization": irq,
+            "liu_layland_bound": n * (2 ** (1.0 / n) - 1),
+            "hyperbolic_product": math.prod(u + 1 for u in cost),
+            "schedulable": all(t.response is not None for t in self.threads),
+        }
+
+
+def report(system, result, out):
+    rows = sorted(system.threads, key=lambda t: (t.priority, t.name))
+    width = max(len(t.name) for t in rows)
+
+    out.write("%-*s  prio  %10s  %10s  %10s  %10s  %10s\n" %
+              (width, "thread", "cost(us)", "block(us)", "resp(us)",
+               "dl(us)", "slack(us)"))
+    for t in rows:
+        if t.response is None:
+            resp, slack = "MISS", "-"
+        else:
+            resp = "%.1f" % t.response
+            slack = "%.1f" % (t.deadline - t.response)
+        block = "inf" if math.isinf(t.blocking) else "%.1f" % t.blocking
+        out.write("%-*s  %4d  %10.1f  %10s  %10s  %10.1f  %10s\n" %
+                  (width, t.name, t.priority, t.cost, block, resp,
+                   t.deadline, slack))
+
+    out.write("\n")
+    out.write("utilization        %.4f (threads %.4f, interrupt %.4f)\n" %
+              (result["utilization"], result["thread_utilization"],
+               result["interrupt_utilization"]))
+    out.write("liu-layland bound  %.4f, %s\n" %
+              (result["liu_layland_bound"],
+               "passed" if result["thread_utilization"] <=
+               result["liu_layland_bound"] else "not passed"))
+    out.write("hyperbolic bound   %.4f <= 2, %s\n" %
+              (result["hyperbolic_product"],
+               "passed" if result["hyperbolic_product"] <= 2 else
+               "not passed"))
+    out.write("response time      %s\n" %
+              ("schedulable" if result["schedulable"] else "NOT schedulable"))
+
+    warnings = system.warnings + ["%s: %s" % (t.name, w)
+                                  for t in rows for w in t.warnings]
+    if warnings:
+        out.write("\nwarning:\n")
+        for w in warnings:
+            out.write("  %s\n" % w)
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    parser = argparse.ArgumentParser(
+        description="SMC-RTOS response-time analysis")
+    parser.add_argument("system", help="JSON description of the system")
+    parser.add_argument("--config",
+                        default=os.path.join(root, "config", "smc_config.h"),
+                        help="smc_config.h for the default tick rate")
+    parser.add_argument("--json", action="store_true",
+                        help="print the result as JSON")
+    args = parser.parse_args()
+
+    try:
+        with open(args.system) as f:
+            desc = json.load(f)
+        system = System(desc, read_config(args.config))
+        result = system.analyse()
+    except (OSError, ValueError, AnalysisError) as e:
+        sys.stderr.write("smc_rta: %s\n" % e)
+        return 2
+
+    if args.json:
+        result["threads"] = [{
+            "name": t.name,
+            "priority": t.priority,
+            "cost_us": t.cost,
+            "blocking_us": None if math.isinf(t.blocking) else t.blocking,
+            "blocker": t.blocker,
+            "response_us": t.response,
+            "deadline_us": t.deadline,
+            "warnings": t.warnings,
+        } for t in system.threads]
+        result["warnings"] = system.warnings
+        json.dump(result, sys.stdout, indent=4)
+        sys.stdout.write("\n")
+    else:
+        report(system, result, sys.stdout)
+
+    return 0 if result["schedulable"] else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())